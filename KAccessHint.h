@@ -0,0 +1,39 @@
+#pragma once
+
+namespace KamaCache
+{
+	//ɨģʽ: ڼ, ǰ̵߳ get λ/Ƶ(ͬ peek), put 뵽̭һ(ͬ putCold)
+	//ɨؽ, һԷʵĴ key ѹ
+	class KScanModeGuard
+	{
+	private:
+		bool previous_; //֧Ƕ, ʱָ״̬
+	public:
+		KScanModeGuard(): previous_(scanning())
+		{
+			scanning() = true;
+		}
+
+		//״̬, ַ߳ʱ״̬
+		explicit KScanModeGuard(bool enabled): previous_(scanning())
+		{
+			scanning() = enabled;
+		}
+
+		~KScanModeGuard()
+		{
+			scanning() = previous_;
+		}
+
+		KScanModeGuard(const KScanModeGuard&) = delete;
+		KScanModeGuard& operator=(const KScanModeGuard&) = delete;
+
+		static bool active() { return scanning(); }
+	private:
+		static bool& scanning()
+		{
+			static thread_local bool flag = false;
+			return flag;
+		}
+	};
+}
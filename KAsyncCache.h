@@ -0,0 +1,627 @@
+#pragma once
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "KAccessHint.h"
+#include "KLruCache.h"
+
+//Ҫ C++20 Э֧
+namespace KamaCache
+{
+	//KExecutor----------Эִӿ, ִЭڼԼǼΪǰ̵ִ߳
+	// KAsyncMutex ϵЭ, ٽɺĺͶݻصǼǵִ, ܵͷ߳
+	class KExecutor
+	{
+	public:
+		virtual ~KExecutor() = default;
+		virtual void post(std::coroutine_handle<> handle) = 0; //ɿ̵߳
+
+		static KExecutor* current() { return currentRef(); } //ǰ߳еִ, ûΪ
+	protected:
+		//ִЭڼ, ʱָǼ(֧Ƕ)
+		class RunningScope
+		{
+		private:
+			KExecutor* previous_;
+		public:
+			explicit RunningScope(KExecutor* executor): previous_(currentRef())
+			{
+				currentRef() = executor;
+			}
+			~RunningScope()
+			{
+				currentRef() = previous_;
+			}
+			RunningScope(const RunningScope&) = delete;
+			RunningScope& operator=(const RunningScope&) = delete;
+		};
+	private:
+		static KExecutor*& currentRef()
+		{
+			static thread_local KExecutor* executor = nullptr;
+			return executor;
+		}
+	};
+
+
+	//KAsyncMutex----------Э̻, ʱЭ̶߳
+	//state_: kNotLocked δ, kLockedNoWaiters Ѽ޵ȴ, ֵΪȴջָ(ջ, LIFO)
+	//ȴʱԼٽ(run), unlock ʱ߰ջת waiters_(FIFO, ֻг߷),
+	//ȴִٽ, ٰѸԵĺͶݻǵִ, п˲ͷ
+	//ƽڱִŶӵЭ, ʱֻٽ
+	class KAsyncMutex
+	{
+	public:
+		struct Waiter
+		{
+			std::coroutine_handle<> handle;
+			KExecutor* executor = nullptr; //ʱ߳ϵִ, Ϊʱֻ unlock ߳ϻָ
+			void (*run)(void* context) = nullptr; //ٽ, ɵʱ߳ڵ, 쳣
+			void* context = nullptr;
+			Waiter* next = nullptr;
+		};
+
+		KAsyncMutex(): state_(kNotLocked), waiters_(nullptr) {}
+		KAsyncMutex(const KAsyncMutex&) = delete;
+		KAsyncMutex& operator=(const KAsyncMutex&) = delete;
+
+		bool tryLock();
+		bool lockOrEnqueue(Waiter& waiter, std::coroutine_handle<> handle); //ӷtrue(, ٽɳߴΪִ), ڼõfalse
+		void unlock(); //Ŷӵĵȴִٽ, ͷ
+	private:
+		static constexpr std::uintptr_t kNotLocked = 1;
+		static constexpr std::uintptr_t kLockedNoWaiters = 0;
+		static constexpr int kMaxResumeDepth = 128; //ָȴߵǶײ
+
+		std::atomic<std::uintptr_t> state_;
+		Waiter* waiters_;
+	private:
+		static void resumeInline(Waiter* waiter); //ڵǰָ̻߳, Ƕ׹ʱӺ
+	};
+
+	inline bool KAsyncMutex::tryLock()
+	{
+		std::uintptr_t expected = kNotLocked;
+		return state_.compare_exchange_strong(expected, kLockedNoWaiters, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	inline bool KAsyncMutex::lockOrEnqueue(Waiter& waiter, std::coroutine_handle<> handle)
+	{
+		waiter.handle = handle;
+		waiter.executor = KExecutor::current();
+		std::uintptr_t old = state_.load(std::memory_order_acquire);
+		while (true)
+		{
+			if (old == kNotLocked)
+			{
+				if (state_.compare_exchange_weak(old, kLockedNoWaiters, std::memory_order_acquire, std::memory_order_relaxed))
+					return false;
+			}
+			else
+			{
+				waiter.next = old == kLockedNoWaiters ? nullptr : reinterpret_cast<Waiter*>(old);
+				if (state_.compare_exchange_weak(old, reinterpret_cast<std::uintptr_t>(&waiter), std::memory_order_release, std::memory_order_relaxed))
+					return true;
+			}
+		}
+	}
+
+	inline void KAsyncMutex::unlock()
+	{
+		//ٽɵĵȴ, ͷͶ/ָ: Ͷݿܻ߳, 
+		Waiter* doneHead = nullptr;
+		Waiter* doneTail = nullptr;
+		while (true)
+		{
+			Waiter* head = waiters_;
+			if (head == nullptr)
+			{
+				std::uintptr_t old = kLockedNoWaiters;
+				if (state_.compare_exchange_strong(old, kNotLocked, std::memory_order_release, std::memory_order_relaxed))
+					break;
+				//µȴջ, ջȡߺתȷ
+				old = state_.exchange(kLockedNoWaiters, std::memory_order_acquire);
+				Waiter* stack = reinterpret_cast<Waiter*>(old);
+				while (stack != nullptr)
+				{
+					Waiter* next = stack->next;
+					stack->next = head;
+					head = stack;
+					stack = next;
+				}
+			}
+			waiters_ = head->next;
+			head->run(head->context);
+			head->next = nullptr;
+			if (doneTail)
+				doneTail->next = head;
+			else
+				doneHead = head;
+			doneTail = head;
+		}
+		while (doneHead)
+		{
+			//Ͷݻָ current ʱʧЧ, ȡһ
+			Waiter* current = doneHead;
+			doneHead = current->next;
+			if (current->executor && current->executor != KExecutor::current())
+				current->executor->post(current->handle); //ֻѺͶݻԼ߳
+			else
+				resumeInline(current);
+		}
+	}
+
+	inline void KAsyncMutex::resumeInline(Waiter* waiter)
+	{
+		//ͬһִϵĵȴ߱߳; κִϵĵȴûб𴦿Ͷ, Ҳָֻ
+		//ָЭ̿ٴ unlock ָĵȴ, Ƕ׹ʱӺ
+		struct Pending
+		{
+			Waiter* head = nullptr;
+			Waiter* tail = nullptr;
+			int depth = 0;
+		};
+		static thread_local Pending pending;
+
+		if (pending.depth >= kMaxResumeDepth)
+		{
+			waiter->next = nullptr;
+			if (pending.tail)
+				pending.tail->next = waiter;
+			else
+				pending.head = waiter;
+			pending.tail = waiter;
+			return;
+		}
+		++pending.depth;
+		waiter->handle.resume(); //resume  waiter ڵЭ֡, ٷ
+		if (pending.depth == 1)
+		{
+			//㸺ָӺĵȴ
+			while (pending.head)
+			{
+				Waiter* current = pending.head;
+				pending.head = current->next;
+				if (!pending.head)
+					pending.tail = nullptr;
+				current->handle.resume();
+			}
+		}
+		--pending.depth;
+	}
+
+
+	//KTask----------Э, co_await ʱſʼִ, ʱԳתƻصȴ
+	template <typename T = void>
+	class KTask;
+
+	struct KTaskPromiseBase
+	{
+		struct FinalAwaiter
+		{
+			bool await_ready() noexcept { return false; }
+			template <typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+			{
+				std::coroutine_handle<> continuation = handle.promise().continuation_;
+				return continuation ? continuation : std::noop_coroutine();
+			}
+			void await_resume() noexcept {}
+		};
+
+		std::coroutine_handle<> continuation_;
+		std::exception_ptr exception_;
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void unhandled_exception() { exception_ = std::current_exception(); }
+	};
+
+	template <typename T>
+	struct KTaskPromise : KTaskPromiseBase
+	{
+		std::optional<T> value_;
+
+		KTask<T> get_return_object();
+		void return_value(T value) { value_.emplace(std::move(value)); }
+		T result()
+		{
+			if (exception_)
+				std::rethrow_exception(exception_);
+			return std::move(*value_);
+		}
+	};
+
+	template <>
+	struct KTaskPromise<void> : KTaskPromiseBase
+	{
+		KTask<void> get_return_object();
+		void return_void() {}
+		void result()
+		{
+			if (exception_)
+				std::rethrow_exception(exception_);
+		}
+	};
+
+	template <typename T>
+	class KTask
+	{
+	public:
+		using promise_type = KTaskPromise<T>;
+	private:
+		std::coroutine_handle<promise_type> handle_;
+	public:
+		explicit KTask(std::coroutine_handle<promise_type> handle): handle_(handle) {}
+		KTask(KTask&& other) noexcept: handle_(std::exchange(other.handle_, {})) {}
+		KTask& operator=(KTask&& other) noexcept
+		{
+			if (this != &other)
+			{
+				if (handle_)
+					handle_.destroy();
+				handle_ = std::exchange(other.handle_, {});
+			}
+			return *this;
+		}
+		KTask(const KTask&) = delete;
+		KTask& operator=(const KTask&) = delete;
+		~KTask()
+		{
+			if (handle_)
+				handle_.destroy();
+		}
+
+		auto operator co_await() const noexcept
+		{
+			struct Awaiter
+			{
+				std::coroutine_handle<promise_type> handle;
+				bool await_ready() const noexcept { return !handle || handle.done(); }
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+				{
+					handle.promise().continuation_ = awaiting;
+					return handle;
+				}
+				T await_resume() { return handle.promise().result(); }
+			};
+			return Awaiter{ handle_ };
+		}
+	};
+
+	template <typename T>
+	KTask<T> KTaskPromise<T>::get_return_object()
+	{
+		return KTask<T>(std::coroutine_handle<KTaskPromise<T>>::from_promise(*this));
+	}
+
+	inline KTask<void> KTaskPromise<void>::get_return_object()
+	{
+		return KTask<void>(std::coroutine_handle<KTaskPromise<void>>::from_promise(*this));
+	}
+
+
+	//KRunLoop----------ִ߳, Ժͻ׼ʹ: spawn  run() ִеȫ
+	class KRunLoop : public KExecutor
+	{
+	public:
+		class ScheduleOperation
+		{
+		private:
+			KRunLoop& loop_;
+		public:
+			explicit ScheduleOperation(KRunLoop& loop): loop_(loop) {}
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle) { loop_.post(handle); }
+			void await_resume() const noexcept {}
+		};
+	private:
+		struct DetachedTask
+		{
+			struct promise_type
+			{
+				DetachedTask get_return_object() { return {}; }
+				std::suspend_never initial_suspend() noexcept { return {}; }
+				std::suspend_never final_suspend() noexcept { return {}; }
+				void return_void() {}
+				void unhandled_exception() { std::terminate(); }
+			};
+		};
+
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		std::deque<std::coroutine_handle<>> queue_;
+		size_t outstanding_; // spawn δ
+	public:
+		KRunLoop(): outstanding_(0) {}
+
+		ScheduleOperation schedule() { return ScheduleOperation(*this); } //co_await ڱִ߳ϼ
+		void post(std::coroutine_handle<> handle) override; //ɿ̵߳
+		void spawn(KTask<void> task);
+		void run();
+	private:
+		DetachedTask runDetached(KTask<void> task);
+		void finishOne();
+	};
+
+	inline void KRunLoop::post(std::coroutine_handle<> handle)
+	{
+		//֪ͨ: ߳Ͷݵһִ run() ̷زִ
+		std::lock_guard<std::mutex> lock(mutex_);
+		queue_.push_back(handle);
+		cv_.notify_one();
+	}
+
+	inline void KRunLoop::spawn(KTask<void> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			++outstanding_;
+		}
+		runDetached(std::move(task));
+	}
+
+	inline void KRunLoop::run()
+	{
+		RunningScope scope(this);
+		while (true)
+		{
+			std::coroutine_handle<> handle;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				cv_.wait(lock, [this] { return !queue_.empty() || outstanding_ == 0; });
+				if (queue_.empty())
+					return;
+				handle = queue_.front();
+				queue_.pop_front();
+			}
+			handle.resume();
+		}
+	}
+
+	inline KRunLoop::DetachedTask KRunLoop::runDetached(KTask<void> task)
+	{
+		co_await schedule();
+		co_await task;
+		finishOne();
+	}
+
+	inline void KRunLoop::finishOne()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		--outstanding_;
+		cv_.notify_all();
+	}
+
+
+	//KAsyncHashCaches----------ƬЭ̽ӿ, ÿƬһ KAsyncMutex
+	//ʱ await_ready ͬ, Ҳڴ; ʱ, ɳ̴߳ΪִзƬ, Լִϼ
+	//ɨģʽڴʱ, ִʱ, ʵ̵ִ߳ thread_local Ӱ
+	//ͬһʵֻӦͨ첽ӿڷ, Ƭڲ std::mutex õ
+	template <typename Key, typename Value, typename SliceCache = KLruSlice<Key, Value>>
+	class KAsyncHashCaches
+	{
+	private:
+		struct Slice
+		{
+			SliceCache cache;
+			KAsyncMutex mutex;
+			explicit Slice(size_t capacity): cache(capacity) {}
+		};
+
+		struct GetFn
+		{
+			Key key;
+			std::optional<Value> operator()(SliceCache& cache) const
+			{
+				Value value{};
+				if (cache.get(key, value))
+					return value;
+				return std::nullopt;
+			}
+		};
+
+		struct PutFn
+		{
+			Key key;
+			Value value;
+			void operator()(SliceCache& cache) const { cache.put(key, value); }
+		};
+	public:
+		//ڷƬִ Fn  awaitable
+		template <typename Fn>
+		class SliceOperation
+		{
+		public:
+			using Result = std::invoke_result_t<Fn&, SliceCache&>;
+		private:
+			Slice& slice_;
+			Fn fn_;
+			bool scanMode_; //ʱ̵߳ɨģʽ, ٽ̴߳Ϊִ
+			KAsyncMutex::Waiter waiter_;
+			std::conditional_t<std::is_void_v<Result>, bool, std::optional<Result>> result_{};
+			std::exception_ptr exception_;
+			bool done_ = false;
+		public:
+			SliceOperation(Slice& slice, Fn fn, bool scanMode): slice_(slice), fn_(std::move(fn)), scanMode_(scanMode) {}
+			bool await_ready()
+			{
+				if (!slice_.mutex.tryLock())
+					return false;
+				complete();
+				return true;
+			}
+			bool await_suspend(std::coroutine_handle<> handle)
+			{
+				waiter_.run = &SliceOperation::runLocked;
+				waiter_.context = this;
+				return slice_.mutex.lockOrEnqueue(waiter_, handle);
+			}
+			Result await_resume()
+			{
+				if (!done_)
+					complete(); //ǰõ, Լִ
+				if (exception_)
+					std::rethrow_exception(exception_);
+				if constexpr (!std::is_void_v<Result>)
+					return std::move(*result_);
+			}
+		private:
+			static void runLocked(void* context)
+			{
+				//÷; 쳣 await_resume ڵȴԼ߳׳
+				SliceOperation* self = static_cast<SliceOperation*>(context);
+				KScanModeGuard scanMode(self->scanMode_);
+				self->done_ = true;
+				try
+				{
+					if constexpr (std::is_void_v<Result>)
+						self->fn_(self->slice_.cache);
+					else
+						self->result_.emplace(self->fn_(self->slice_.cache));
+				}
+				catch (...)
+				{
+					self->exception_ = std::current_exception();
+				}
+			}
+
+			void complete()
+			{
+				runLocked(this);
+				slice_.mutex.unlock();
+			}
+		};
+		//getOrLoadAsync  awaitable: ʱ await_ready ͬ, ֻδлʱŴЭ
+		template <typename Loader>
+		class LoadOperation
+		{
+		private:
+			using TaskAwaiter = decltype(std::declval<const KTask<Value>&>().operator co_await());
+
+			KAsyncHashCaches& owner_;
+			Key key_;
+			Loader loader_;
+			bool scanMode_;
+			std::optional<Value> cached_;
+			bool miss_ = false; //await_ready ȷδ, Э̲ٲһ
+			std::optional<KTask<Value>> task_;
+			std::optional<TaskAwaiter> taskAwaiter_;
+		public:
+			LoadOperation(KAsyncHashCaches& owner, Key key, Loader loader, bool scanMode):
+				owner_(owner), key_(std::move(key)), loader_(std::move(loader)), scanMode_(scanMode) {}
+			bool await_ready()
+			{
+				SliceOperation<GetFn> lookup(owner_.sliceFor(key_), GetFn{ key_ }, scanMode_);
+				if (!lookup.await_ready())
+					return false; //Ƭռ, ЭŶӲ
+				cached_ = lookup.await_resume();
+				miss_ = !cached_;
+				return !miss_;
+			}
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle)
+			{
+				task_.emplace(owner_.loadAndStore(key_, std::move(loader_), !miss_, scanMode_));
+				taskAwaiter_.emplace(task_->operator co_await());
+				return taskAwaiter_->await_suspend(handle);
+			}
+			Value await_resume()
+			{
+				if (!task_)
+					return std::move(*cached_);
+				return taskAwaiter_->await_resume();
+			}
+		};
+	private:
+		size_t capacity_;
+		int sliceNum_;
+		std::vector<std::unique_ptr<Slice>> slices_;
+	private:
+		size_t Hash(const Key& key);
+		Slice& sliceFor(const Key& key);
+		template <typename Loader>
+		KTask<Value> loadAndStore(Key key, Loader loader, bool lookup, bool scanMode);
+	public:
+		KAsyncHashCaches(size_t capacity, int sliceNum):
+			capacity_(capacity),
+			sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
+		{
+			size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_));
+			for (int i = 0; i < sliceNum_; i++)
+			{
+				slices_.emplace_back(std::make_unique<Slice>(sliceSize));
+			}
+		}
+
+		SliceOperation<GetFn> getAsync(Key key); //co_await õ std::optional<Value>
+		SliceOperation<PutFn> putAsync(Key key, Value value);
+		//δʱ co_await loader(key) زд; δͬһ key ʱԼ
+		template <typename Loader>
+		LoadOperation<Loader> getOrLoadAsync(Key key, Loader loader);
+		int getSliceNum() const
+		{
+			return sliceNum_;
+		}
+	};
+
+	template <typename Key, typename Value, typename SliceCache>
+	size_t KAsyncHashCaches<Key, Value, SliceCache>::Hash(const Key& key)
+	{
+		std::hash<Key> hashFunc;
+		return hashFunc(key);
+	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	typename KAsyncHashCaches<Key, Value, SliceCache>::Slice& KAsyncHashCaches<Key, Value, SliceCache>::sliceFor(const Key& key)
+	{
+		return *slices_[Hash(key) % sliceNum_];
+	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	typename KAsyncHashCaches<Key, Value, SliceCache>::template SliceOperation<typename KAsyncHashCaches<Key, Value, SliceCache>::GetFn>
+	KAsyncHashCaches<Key, Value, SliceCache>::getAsync(Key key)
+	{
+		return SliceOperation<GetFn>(sliceFor(key), GetFn{ key }, KScanModeGuard::active());
+	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	typename KAsyncHashCaches<Key, Value, SliceCache>::template SliceOperation<typename KAsyncHashCaches<Key, Value, SliceCache>::PutFn>
+	KAsyncHashCaches<Key, Value, SliceCache>::putAsync(Key key, Value value)
+	{
+		return SliceOperation<PutFn>(sliceFor(key), PutFn{ key, value }, KScanModeGuard::active());
+	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	template <typename Loader>
+	typename KAsyncHashCaches<Key, Value, SliceCache>::template LoadOperation<Loader>
+	KAsyncHashCaches<Key, Value, SliceCache>::getOrLoadAsync(Key key, Loader loader)
+	{
+		return LoadOperation<Loader>(*this, std::move(key), std::move(loader), KScanModeGuard::active());
+	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	template <typename Loader>
+	KTask<Value> KAsyncHashCaches<Key, Value, SliceCache>::loadAndStore(Key key, Loader loader, bool lookup, bool scanMode)
+	{
+		if (lookup)
+		{
+			std::optional<Value> cached = co_await SliceOperation<GetFn>(sliceFor(key), GetFn{ key }, scanMode);
+			if (cached)
+				co_return std::move(*cached);
+		}
+		Value value = co_await loader(key);
+		co_await SliceOperation<PutFn>(sliceFor(key), PutFn{ key, value }, scanMode);
+		co_return value;
+	}
+}
@@ -0,0 +1,340 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "KICachePolicy.h"
+#include "KAccessHint.h"
+
+namespace KamaCache
+{
+	//key  value ƽ㹻Сʱ, ýղִ LruNode + shared_ptr + unordered_map
+	template <typename Key, typename Value>
+	struct KUseCompactLayout: std::integral_constant<bool,
+		std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value &&
+		sizeof(Key) <= 16 && sizeof(Value) <= 64>
+	{
+	};
+
+	//KCompactLruCache----------̶, ṹ(SoA)
+	//Ŀ±꼴λ: keys_/values_/prev_/next_ ±겢д,  32 λ±ָ
+	//Ϊ̽ĿѰַ, ɾʱƲλ, Ĺ
+	//סĿժ² prev_ Ϊ kNil, ռÿռ
+	template <typename Key, typename Value>
+	class KCompactLruCache : public KICachePolicy<Key, Value>
+	{
+	private:
+		static constexpr uint32_t kNil = UINT32_MAX;
+
+		uint32_t capacity_;
+		uint32_t size_;
+		uint32_t freeHead_;	//вλ,  next_ 
+		uint32_t sentinel_;	//ڱ± == capacity_, next_ ָδ, prev_ ָ
+		int indexBits_;
+		std::vector<Key> keys_;
+		std::vector<Value> values_;
+		std::vector<uint32_t> prev_;
+		std::vector<uint32_t> next_;
+		std::vector<uint32_t> index_;	//ϣ -- Ŀ±, СΪ 2 ҲС 2 
+		std::mutex mutex_;
+	public:
+		KCompactLruCache(int capacity);
+
+		~KCompactLruCache() override = default;
+
+		void put(Key key, Value value) override;
+		bool get(Key key, Value& value) override;
+		Value get(Key key) override;
+		void remove(Key key);
+		bool peek(Key key, Value& value);
+		void putCold(Key key, Value value);
+		bool pin(Key key);
+		bool unpin(Key key);
+		size_t memoryBytes() const; //Ԥռõֽ
+	private:
+		size_t indexSlot(const Key& key) const; //key ĳʼ̽λ
+		uint32_t findEntry(const Key& key) const; //Ŀ±, Ϊ kNil
+		void indexInsert(uint32_t entry);
+		void indexErase(uint32_t entry);
+		void addNewEntry(const Key& key, const Value& value, bool cold);
+		bool isPinned(uint32_t entry) const { return prev_[entry] == kNil; }
+		void moveToMostRecent(uint32_t entry);
+		void removeNode(uint32_t entry);
+		void insertNode(uint32_t entry);
+		void insertNodeAtHead(uint32_t entry);
+		bool evictLeastRecent();
+		void releaseEntry(uint32_t entry); //ɾ黹
+	};
+
+	template <typename Key, typename Value>
+	constexpr uint32_t KCompactLruCache<Key, Value>::kNil;
+
+	template <typename Key, typename Value>
+	KCompactLruCache<Key, Value>::KCompactLruCache(int capacity):
+		capacity_(capacity > 0 ? static_cast<uint32_t>(capacity) : 0),
+		size_(0),
+		freeHead_(kNil),
+		sentinel_(capacity_),
+		indexBits_(1),
+		keys_(capacity_),
+		values_(capacity_),
+		prev_(capacity_ + 1),
+		next_(capacity_ + 1)
+	{
+		while ((size_t(1) << indexBits_) < size_t(capacity_) * 2)
+			++indexBits_;
+		index_.assign(size_t(1) << indexBits_, kNil);
+		prev_[sentinel_] = sentinel_;
+		next_[sentinel_] = sentinel_;
+		//±˳, õ±, ʸ
+		for (uint32_t i = capacity_; i > 0; i--)
+		{
+			next_[i - 1] = freeHead_;
+			freeHead_ = i - 1;
+		}
+	}
+
+	//public
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::put(Key key, Value value)
+	{
+		if (capacity_ == 0)
+			return;
+		if (KScanModeGuard::active())
+		{
+			putCold(key, value);
+			return;
+		}
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t entry = findEntry(key);
+		if (entry != kNil)
+		{
+			values_[entry] = value;
+			moveToMostRecent(entry);
+			return;
+		}
+		addNewEntry(key, value, false);
+	}
+
+	template <typename Key, typename Value>
+	bool KCompactLruCache<Key, Value>::get(Key key, Value& value)
+	{
+		if (KScanModeGuard::active())
+			return peek(key, value);
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t entry = findEntry(key);
+		if (entry == kNil)
+			return false;
+		moveToMostRecent(entry);
+		value = values_[entry];
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	Value KCompactLruCache<Key, Value>::get(Key key)
+	{
+		Value value{};
+		get(key, value);
+		return value;
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::remove(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t entry = findEntry(key);
+		if (entry == kNil)
+			return;
+		if (!isPinned(entry))
+			removeNode(entry);
+		releaseEntry(entry);
+	}
+
+	template <typename Key, typename Value>
+	bool KCompactLruCache<Key, Value>::peek(Key key, Value& value)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t entry = findEntry(key);
+		if (entry == kNil)
+			return false;
+		value = values_[entry];
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::putCold(Key key, Value value)
+	{
+		if (capacity_ == 0)
+			return;
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t entry = findEntry(key);
+		if (entry != kNil)
+		{
+			values_[entry] = value;
+			return;
+		}
+		addNewEntry(key, value, true);
+	}
+
+	template <typename Key, typename Value>
+	bool KCompactLruCache<Key, Value>::pin(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t entry = findEntry(key);
+		if (entry == kNil)
+			return false;
+		if (!isPinned(entry))
+		{
+			removeNode(entry);
+			prev_[entry] = kNil;
+		}
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	bool KCompactLruCache<Key, Value>::unpin(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t entry = findEntry(key);
+		if (entry == kNil)
+			return false;
+		if (isPinned(entry))
+			insertNode(entry);
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	size_t KCompactLruCache<Key, Value>::memoryBytes() const
+	{
+		return keys_.capacity() * sizeof(Key) + values_.capacity() * sizeof(Value) +
+			(prev_.capacity() + next_.capacity() + index_.capacity()) * sizeof(uint32_t);
+	}
+
+	//private
+	template <typename Key, typename Value>
+	size_t KCompactLruCache<Key, Value>::indexSlot(const Key& key) const
+	{
+		//std::hash Ǻӳ, ͬһƬ key ģƬͬ, ó˷ɢдɢλ
+		uint64_t h = static_cast<uint64_t>(std::hash<Key>()(key)) * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>(h >> (64 - indexBits_));
+	}
+
+	template <typename Key, typename Value>
+	uint32_t KCompactLruCache<Key, Value>::findEntry(const Key& key) const
+	{
+		if (capacity_ == 0)
+			return kNil;
+		size_t mask = index_.size() - 1;
+		for (size_t slot = indexSlot(key); index_[slot] != kNil; slot = (slot + 1) & mask)
+		{
+			if (keys_[index_[slot]] == key)
+				return index_[slot];
+		}
+		return kNil;
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::indexInsert(uint32_t entry)
+	{
+		size_t mask = index_.size() - 1;
+		size_t slot = indexSlot(keys_[entry]);
+		while (index_[slot] != kNil)
+			slot = (slot + 1) & mask;
+		index_[slot] = entry;
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::indexErase(uint32_t entry)
+	{
+		size_t mask = index_.size() - 1;
+		size_t slot = indexSlot(keys_[entry]);
+		while (index_[slot] != entry)
+			slot = (slot + 1) & mask;
+		//Ʋλ: Ѻܻ̽λĿǰ, ֤Ҳǰղ
+		size_t hole = slot;
+		for (size_t next = (hole + 1) & mask; index_[next] != kNil; next = (next + 1) & mask)
+		{
+			size_t home = indexSlot(keys_[index_[next]]);
+			if (((next - home) & mask) >= ((next - hole) & mask))
+			{
+				index_[hole] = index_[next];
+				hole = next;
+			}
+		}
+		index_[hole] = kNil;
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::addNewEntry(const Key& key, const Value& value, bool cold)
+	{
+		if (size_ >= capacity_ && !evictLeastRecent())
+			return; //ȫס, 
+		uint32_t entry = freeHead_;
+		freeHead_ = next_[entry];
+		keys_[entry] = key;
+		values_[entry] = value;
+		if (cold)
+			insertNodeAtHead(entry);
+		else
+			insertNode(entry);
+		indexInsert(entry);
+		++size_;
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::moveToMostRecent(uint32_t entry)
+	{
+		if (isPinned(entry))
+			return;
+		removeNode(entry);
+		insertNode(entry);
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::removeNode(uint32_t entry)
+	{
+		next_[prev_[entry]] = next_[entry];
+		prev_[next_[entry]] = prev_[entry];
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::insertNode(uint32_t entry)
+	{
+		uint32_t last = prev_[sentinel_];
+		prev_[entry] = last;
+		next_[entry] = sentinel_;
+		next_[last] = entry;
+		prev_[sentinel_] = entry;
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::insertNodeAtHead(uint32_t entry)
+	{
+		uint32_t first = next_[sentinel_];
+		prev_[entry] = sentinel_;
+		next_[entry] = first;
+		prev_[first] = entry;
+		next_[sentinel_] = entry;
+	}
+
+	template <typename Key, typename Value>
+	bool KCompactLruCache<Key, Value>::evictLeastRecent()
+	{
+		uint32_t leastRecent = next_[sentinel_];
+		if (leastRecent == sentinel_)
+			return false;
+		removeNode(leastRecent);
+		releaseEntry(leastRecent);
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	void KCompactLruCache<Key, Value>::releaseEntry(uint32_t entry)
+	{
+		indexErase(entry);
+		next_[entry] = freeHead_;
+		freeHead_ = entry;
+		--size_;
+	}
+}
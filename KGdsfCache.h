@@ -0,0 +1,376 @@
+#pragma once
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "KICachePolicy.h"
+
+namespace KamaCache
+{
+	//GreedyDual-Size-Frequency: ȼ H = L + freq * cost / size, ̭ H СĽڵ
+	//L ȫʱ, ÿ̭Ϊ̭ڵ H, ʹ·ʵĽڵȼ̧(ϻ)
+
+	template <typename Key, typename Value>
+	class KGdsfCache;
+
+	template <typename Key, typename Value>
+	class GdsfNode
+	{
+	private:
+		Key key_;
+		Value value_;
+		double cost_;	//δʱ¼/صĴ
+		size_t size_;	//ռõλ, Ĭ 1 Ŀ
+		size_t freq_;
+		double priority_;	//H ֵ
+		size_t tick_;	//, H ͬʱ̭δʵ
+		size_t heapIndex_;	//ڶе±, ȼʱ O(log n) 
+
+	public:
+		GdsfNode(Key key, Value value, double cost, size_t size):
+			key_(key),
+			value_(value),
+			cost_(cost),
+			size_(size),
+			freq_(1),
+			priority_(0),
+			tick_(0),
+			heapIndex_(0)
+		{
+		}
+
+		Key getKey() const { return key_; }
+		Value getValue() const { return value_; }
+		double getCost() const { return cost_; }
+		size_t getSize() const { return size_; }
+		size_t getFreq() const { return freq_; }
+
+		friend class KGdsfCache<Key, Value>;
+	};
+
+	template <typename Key, typename Value>
+	class KGdsfCache : public KICachePolicy<Key, Value>
+	{
+	public:
+		using GdsfNodeType = GdsfNode<Key, Value>;
+		using NodePtr = std::shared_ptr<GdsfNodeType>;
+		using NodeMap = std::unordered_map<Key, NodePtr>;
+	private:
+		size_t capacity_;	//λ
+		size_t usedSize_;
+		double clock_;	//ȫʱ L
+		size_t tick_;
+		NodeMap nodeMap_;
+		std::vector<NodePtr> heap_;	// H С, ѶΪ̭ѡ
+		std::mutex mutex_;
+	public:
+		KGdsfCache(size_t capacity):
+			capacity_(capacity),
+			usedSize_(0),
+			clock_(0),
+			tick_(0)
+		{
+		}
+
+		~KGdsfCache() override = default;
+
+		void put(Key key, Value value) override; //cost = 1, size = 1, ˻Ϊϻ LFU
+		//size Ϊ 0 򳬹ʱ沢 false, ͬ key ľĿҲᱻɾ, ؾֵ
+		bool put(Key key, Value value, double cost, size_t size = 1);
+		bool get(Key key, Value& value) override;
+		Value get(Key key) override;
+		void remove(Key key);
+		double getClock();
+		size_t getUsedSize();
+	private:
+		double computePriority(const NodePtr& node) const;
+		void touchNode(NodePtr node); //: freq++, ¼ H 
+		void evictLowestPriority(); //Ѷ, ƽȫʱ
+		void heapPush(NodePtr node);
+		void heapErase(size_t index);
+		void siftUp(size_t index);
+		void siftDown(size_t index);
+		bool lessThan(const NodePtr& a, const NodePtr& b) const;
+		void swapNodes(size_t i, size_t j);
+	};
+
+	//public
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::put(Key key, Value value)
+	{
+		put(key, value, 1.0, 1);
+	}
+
+	template <typename Key, typename Value>
+	bool KGdsfCache<Key, Value>::put(Key key, Value value, double cost, size_t size)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		NodePtr node;
+		auto it = nodeMap_.find(key);
+		bool admit = size > 0 && size <= capacity_;
+		if (it != nodeMap_.end() && !admit)
+		{
+			//ֵŲ, ֵѹ, һɾ
+			usedSize_ -= it->second->size_;
+			heapErase(it->second->heapIndex_);
+			nodeMap_.erase(it);
+			return false;
+		}
+		if (!admit)
+			return false;
+		if (it != nodeMap_.end())
+		{
+			//ʱȰѾĿƳڿռ, ²ͬ׼, ѸдĿԼ̭
+			node = it->second;
+			usedSize_ -= node->size_;
+			heapErase(node->heapIndex_);
+			nodeMap_.erase(it);
+			node->value_ = value;
+			node->cost_ = cost;
+			node->size_ = size;
+			++node->freq_;
+		}
+		else
+		{
+			node = std::make_shared<GdsfNodeType>(key, value, cost, size);
+		}
+
+		while (usedSize_ + size > capacity_)
+			evictLowestPriority();
+		node->priority_ = computePriority(node);
+		node->tick_ = ++tick_;
+		nodeMap_[key] = node;
+		heapPush(node);
+		usedSize_ += size;
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	bool KGdsfCache<Key, Value>::get(Key key, Value& value)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it != nodeMap_.end())
+		{
+			touchNode(it->second);
+			value = it->second->value_;
+			return true;
+		}
+		return false;
+	}
+
+	template <typename Key, typename Value>
+	Value KGdsfCache<Key, Value>::get(Key key)
+	{
+		Value value{};
+		get(key, value);
+		return value;
+	}
+
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::remove(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it != nodeMap_.end())
+		{
+			usedSize_ -= it->second->size_;
+			heapErase(it->second->heapIndex_);
+			nodeMap_.erase(it);
+		}
+	}
+
+	template <typename Key, typename Value>
+	double KGdsfCache<Key, Value>::getClock()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return clock_;
+	}
+
+	template <typename Key, typename Value>
+	size_t KGdsfCache<Key, Value>::getUsedSize()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return usedSize_;
+	}
+
+	//private
+	template <typename Key, typename Value>
+	double KGdsfCache<Key, Value>::computePriority(const NodePtr& node) const
+	{
+		return clock_ + static_cast<double>(node->freq_) * node->cost_ / static_cast<double>(node->size_);
+	}
+
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::touchNode(NodePtr node)
+	{
+		++node->freq_;
+		node->priority_ = computePriority(node);
+		node->tick_ = ++tick_;
+		//ȫʱֻ, к H ֻ, ֻ³
+		siftDown(node->heapIndex_);
+	}
+
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::evictLowestPriority()
+	{
+		if (heap_.empty())
+			return;
+		NodePtr victim = heap_.front();
+		clock_ = victim->priority_; //L ƽ̭ڵ H
+		usedSize_ -= victim->size_;
+		heapErase(0);
+		nodeMap_.erase(victim->key_);
+	}
+
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::heapPush(NodePtr node)
+	{
+		node->heapIndex_ = heap_.size();
+		heap_.push_back(node);
+		siftUp(node->heapIndex_);
+	}
+
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::heapErase(size_t index)
+	{
+		size_t last = heap_.size() - 1;
+		if (index != last)
+			swapNodes(index, last);
+		heap_.pop_back();
+		if (index < heap_.size())
+		{
+			//ĩβڵҪϸ³
+			siftUp(index);
+			siftDown(index);
+		}
+	}
+
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::siftUp(size_t index)
+	{
+		while (index > 0)
+		{
+			size_t parent = (index - 1) / 2;
+			if (!lessThan(heap_[index], heap_[parent]))
+				break;
+			swapNodes(index, parent);
+			index = parent;
+		}
+	}
+
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::siftDown(size_t index)
+	{
+		size_t n = heap_.size();
+		while (true)
+		{
+			size_t smallest = index;
+			size_t left = index * 2 + 1;
+			size_t right = left + 1;
+			if (left < n && lessThan(heap_[left], heap_[smallest]))
+				smallest = left;
+			if (right < n && lessThan(heap_[right], heap_[smallest]))
+				smallest = right;
+			if (smallest == index)
+				break;
+			swapNodes(index, smallest);
+			index = smallest;
+		}
+	}
+
+	template <typename Key, typename Value>
+	bool KGdsfCache<Key, Value>::lessThan(const NodePtr& a, const NodePtr& b) const
+	{
+		if (a->priority_ != b->priority_)
+			return a->priority_ < b->priority_;
+		return a->tick_ < b->tick_;
+	}
+
+	template <typename Key, typename Value>
+	void KGdsfCache<Key, Value>::swapNodes(size_t i, size_t j)
+	{
+		std::swap(heap_[i], heap_[j]);
+		heap_[i]->heapIndex_ = i;
+		heap_[j]->heapIndex_ = j;
+	}
+
+
+	//KHashGdsfCache----------Ƭ汾, ÿƬάԼĶѺȫʱ
+	template <typename Key, typename Value>
+	class KHashGdsfCache
+	{
+	private:
+		size_t capacity_;
+		int sliceNum_;
+		std::vector<std::unique_ptr<KGdsfCache<Key, Value>>> gdsfSliceCaches_;
+	private:
+		size_t Hash(Key key);
+	public:
+		KHashGdsfCache(size_t capacity, int sliceNum):
+			capacity_(capacity),
+			sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
+		{
+			size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_));
+			for (int i = 0; i < sliceNum_; i++)
+			{
+				gdsfSliceCaches_.emplace_back(std::make_unique<KGdsfCache<Key, Value>>(sliceSize));
+			}
+		}
+		void put(Key key, Value value);
+		//ĿֻܷŽڷƬ, size Ƭ ceil(capacity / sliceNum) ʱ沢 false
+		bool put(Key key, Value value, double cost, size_t size = 1);
+		bool get(Key key, Value& value);
+		Value get(Key key);
+		void remove(Key key);
+		int getSliceNum() const
+		{
+			return sliceNum_;
+		}
+	};
+
+	template <typename Key, typename Value>
+	size_t KHashGdsfCache<Key, Value>::Hash(Key key)
+	{
+		std::hash<Key> hashFunc;
+		return hashFunc(key);
+	}
+
+	template <typename Key, typename Value>
+	void KHashGdsfCache<Key, Value>::put(Key key, Value value)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		gdsfSliceCaches_[sliceIndex]->put(key, value);
+	}
+
+	template <typename Key, typename Value>
+	bool KHashGdsfCache<Key, Value>::put(Key key, Value value, double cost, size_t size)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		return gdsfSliceCaches_[sliceIndex]->put(key, value, cost, size);
+	}
+
+	template <typename Key, typename Value>
+	bool KHashGdsfCache<Key, Value>::get(Key key, Value& value)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		return gdsfSliceCaches_[sliceIndex]->get(key, value);
+	}
+
+	template <typename Key, typename Value>
+	Value KHashGdsfCache<Key, Value>::get(Key key)
+	{
+		Value value{};
+		get(key, value);
+		return value;
+	}
+
+	template <typename Key, typename Value>
+	void KHashGdsfCache<Key, Value>::remove(Key key)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		gdsfSliceCaches_[sliceIndex]->remove(key);
+	}
+}
@@ -0,0 +1,276 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+namespace KamaCache
+{
+	//ȵ key , count ΪƷʴ(ѳ˲), ʵֵ [count - error, count]
+	template <typename Key>
+	struct KHotKey
+	{
+		Key key;
+		size_t count;
+		size_t error;
+		double rate;	//ÿʴ,  KHotKeyWindow ʱΪһڵ
+		int sliceIndex;	//ڷƬ, ʱΪ -1
+	};
+
+	//Space-Saving 㷨: ̶ capacity , Ժ key СǸ
+	//֯ɴ±С, offer Ϊ O(log capacity), ߳ͬ, ɵ÷
+	template <typename Key>
+	class KSpaceSaving
+	{
+	private:
+		struct Counter
+		{
+			Key key;
+			size_t count;
+			size_t error;
+		};
+		using Clock = std::chrono::steady_clock;
+
+		size_t capacity_;
+		size_t totalCount_;	//ȫȨغ
+		Clock::time_point windowStart_;
+		std::vector<Counter> heap_;	// count С
+		std::unordered_map<Key, size_t> index_;	//key --  heap_ е±
+	public:
+		explicit KSpaceSaving(size_t capacity):
+			capacity_(capacity),
+			totalCount_(0),
+			windowStart_(Clock::now())
+		{
+			heap_.reserve(capacity);
+		}
+
+		void offer(const Key& key, size_t weight = 1);
+		std::vector<KHotKey<Key>> topK(size_t k) const;
+		size_t getTotalCount() const { return totalCount_; }
+		size_t getTrackedNum() const { return heap_.size(); }
+		double getTotalRate() const { return totalCount_ / elapsedSeconds(); }
+		void reset(); //ռ, ʼµͳƴ
+	private:
+		double elapsedSeconds() const;
+		void siftDown(size_t index);
+		void swapCounters(size_t i, size_t j);
+	};
+
+	template <typename Key>
+	void KSpaceSaving<Key>::offer(const Key& key, size_t weight)
+	{
+		if (capacity_ == 0)
+			return;
+		totalCount_ += weight;
+		auto it = index_.find(key);
+		if (it != index_.end())
+		{
+			//ֻ, ֻ³
+			heap_[it->second].count += weight;
+			siftDown(it->second);
+			return;
+		}
+		if (heap_.size() < capacity_)
+		{
+			//¼С weight, пиֵ, Ҫϸ
+			heap_.push_back(Counter{ key, weight, 0 });
+			size_t index = heap_.size() - 1;
+			index_[key] = index;
+			while (index > 0 && heap_[index].count < heap_[(index - 1) / 2].count)
+			{
+				swapCounters(index, (index - 1) / 2);
+				index = (index - 1) / 2;
+			}
+			return;
+		}
+		//С key, ļΪ
+		Counter& minCounter = heap_.front();
+		index_.erase(minCounter.key);
+		minCounter.error = minCounter.count;
+		minCounter.count += weight;
+		minCounter.key = key;
+		index_[key] = 0;
+		siftDown(0);
+	}
+
+	template <typename Key>
+	std::vector<KHotKey<Key>> KSpaceSaving<Key>::topK(size_t k) const
+	{
+		std::vector<Counter> counters(heap_);
+		k = std::min(k, counters.size());
+		std::partial_sort(counters.begin(), counters.begin() + k, counters.end(),
+			[](const Counter& a, const Counter& b) { return a.count > b.count; });
+		double seconds = elapsedSeconds();
+		std::vector<KHotKey<Key>> result;
+		result.reserve(k);
+		for (size_t i = 0; i < k; i++)
+			result.push_back(KHotKey<Key>{ counters[i].key, counters[i].count, counters[i].error, counters[i].count / seconds, -1 });
+		return result;
+	}
+
+	template <typename Key>
+	void KSpaceSaving<Key>::reset()
+	{
+		heap_.clear();
+		index_.clear();
+		totalCount_ = 0;
+		windowStart_ = Clock::now();
+	}
+
+	template <typename Key>
+	double KSpaceSaving<Key>::elapsedSeconds() const
+	{
+		double seconds = std::chrono::duration<double>(Clock::now() - windowStart_).count();
+		return seconds > 1e-9 ? seconds : 1e-9;
+	}
+
+	template <typename Key>
+	void KSpaceSaving<Key>::siftDown(size_t index)
+	{
+		size_t n = heap_.size();
+		while (true)
+		{
+			size_t smallest = index;
+			size_t left = index * 2 + 1;
+			size_t right = left + 1;
+			if (left < n && heap_[left].count < heap_[smallest].count)
+				smallest = left;
+			if (right < n && heap_[right].count < heap_[smallest].count)
+				smallest = right;
+			if (smallest == index)
+				break;
+			swapCounters(index, smallest);
+			index = smallest;
+		}
+	}
+
+	template <typename Key>
+	void KSpaceSaving<Key>::swapCounters(size_t i, size_t j)
+	{
+		std::swap(heap_[i], heap_[j]);
+		index_[heap_[i].key] = i;
+		index_[heap_[j].key] = j;
+	}
+
+
+	//KHotKeyWindow----------ȵͳ,  Space-Saving ֻ, ڵķʲһֱռ top-K
+	//ÿһ, ǰתΪһ, ֱӶ
+	//ѯʱһڵļδı뵱ǰ,  window ڵķ
+	template <typename Key>
+	class KHotKeyWindow
+	{
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		Clock::duration window_;
+		Clock::time_point currentStart_;
+		bool hasPrevious_;	//previous_ Ƿ񸲸һ
+		KSpaceSaving<Key> current_;
+		KSpaceSaving<Key> previous_;
+	public:
+		KHotKeyWindow(size_t capacity, double windowSeconds):
+			window_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(windowSeconds > 0 ? windowSeconds : 1.0))),
+			currentStart_(Clock::now()),
+			hasPrevious_(false),
+			current_(capacity),
+			previous_(capacity)
+		{
+		}
+
+		void offer(const Key& key, size_t weight = 1);
+		std::vector<KHotKey<Key>> topK(size_t k);
+		double getTotalRate();
+		void reset();
+	private:
+		double rotate(); //ǰʱֻ, һڼ
+		double coveredSeconds(double previousWeight) const; //ͳƸǵʱ
+	};
+
+	template <typename Key>
+	void KHotKeyWindow<Key>::offer(const Key& key, size_t weight)
+	{
+		rotate();
+		current_.offer(key, weight);
+	}
+
+	template <typename Key>
+	std::vector<KHotKey<Key>> KHotKeyWindow<Key>::topK(size_t k)
+	{
+		double previousWeight = rotate();
+		std::unordered_map<Key, KHotKey<Key>> merged;
+		for (const auto& hotKey : current_.topK(current_.getTrackedNum()))
+			merged.emplace(hotKey.key, hotKey);
+		if (hasPrevious_)
+		{
+			for (const auto& hotKey : previous_.topK(previous_.getTrackedNum()))
+			{
+				auto it = merged.emplace(hotKey.key, KHotKey<Key>{ hotKey.key, 0, 0, 0, -1 }).first;
+				it->second.count += static_cast<size_t>(hotKey.count * previousWeight);
+				it->second.error += static_cast<size_t>(hotKey.error * previousWeight);
+			}
+		}
+
+		std::vector<KHotKey<Key>> result;
+		result.reserve(merged.size());
+		double seconds = coveredSeconds(previousWeight);
+		for (auto& pair : merged)
+		{
+			pair.second.rate = pair.second.count / seconds;
+			result.push_back(pair.second);
+		}
+		k = std::min(k, result.size());
+		std::partial_sort(result.begin(), result.begin() + k, result.end(),
+			[](const KHotKey<Key>& a, const KHotKey<Key>& b) { return a.count > b.count; });
+		result.resize(k);
+		return result;
+	}
+
+	template <typename Key>
+	double KHotKeyWindow<Key>::getTotalRate()
+	{
+		double previousWeight = rotate();
+		double total = current_.getTotalCount();
+		if (hasPrevious_)
+			total += previous_.getTotalCount() * previousWeight;
+		return total / coveredSeconds(previousWeight);
+	}
+
+	template <typename Key>
+	void KHotKeyWindow<Key>::reset()
+	{
+		current_.reset();
+		previous_.reset();
+		hasPrevious_ = false;
+		currentStart_ = Clock::now();
+	}
+
+	template <typename Key>
+	double KHotKeyWindow<Key>::rotate()
+	{
+		Clock::time_point now = Clock::now();
+		if (now - currentStart_ >= window_ * 2)
+		{
+			//ûз, ȫ
+			reset();
+			return 1.0;
+		}
+		if (now - currentStart_ >= window_)
+		{
+			std::swap(current_, previous_);
+			current_.reset();
+			hasPrevious_ = true;
+			currentStart_ += window_;
+		}
+		return 1.0 - std::chrono::duration<double>(now - currentStart_) / window_;
+	}
+
+	template <typename Key>
+	double KHotKeyWindow<Key>::coveredSeconds(double previousWeight) const
+	{
+		//һʱ (ѹȥĵǰ + һ) == һ
+		double windowSeconds = std::chrono::duration<double>(window_).count();
+		double seconds = hasPrevious_ ? windowSeconds : (1.0 - previousWeight) * windowSeconds;
+		return seconds > 1e-9 ? seconds : 1e-9;
+	}
+}
@@ -1,11 +1,15 @@
 #pragma once
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 #include "KICachePolicy.h"
+#include "KAccessHint.h"
+#include "KHotKeySketch.h"
 
 namespace KamaCache
 {
@@ -24,8 +28,9 @@ namespace KamaCache
 			Value value;
 			std::weak_ptr<Node> pre;
 			std::shared_ptr<Node> next;
-			Node(): freq(1), next(nullptr){}
-			Node(Key key, Value value): key(key), value(value), freq(1), next(nullptr){}
+			bool pinned; //סĽڵ㲻κ freqList , ̭ʱȻ
+			Node(): freq(1), next(nullptr), pinned(false){}
+			Node(Key key, Value value): key(key), value(value), freq(1), next(nullptr), pinned(false){}
 		};
 		using NodePtr = std::shared_ptr<Node>; //use NodePtr instead of Node*
 		int freq_;  //ǴŽڵƵ, ǲ, ڴžͬʴĽڵ, LfuҪõ
@@ -42,6 +47,7 @@ namespace KamaCache
 		}
 		bool isEmpty() const; 
 		void addNode(NodePtr node); //β巨, ͬfreqkeyLrṷ
+		void addNodeToHead(NodePtr node); //ͷ巨, ͬfreqȱ̭
 		void removeNode(NodePtr node); 
 		NodePtr getFirstNode() const; //̭һЧڵ
 		friend class KLfuCache<Key, Value>;
@@ -64,13 +70,18 @@ namespace KamaCache
 		NodeMap nodeMap_; //key -- node(pointer)
 		//std::unordered_map<int, FreqList<Key, Value>*> freqToFreqList_; //freq -- FreqList(class)
 		std::unordered_map<int, std::shared_ptr<FreqList<Key, Value>>> freqToFreqList_;
+		std::unique_ptr<KHotKeyWindow<Key>> hotKeys_; //ȵ key ͳ, δʱΪ
+		int sampleInterval_;
+		uint64_t sampleState_; //Ƭ˽е xorshift ״̬, Էģʽ
 	public:
 		KLfuCache(int capacity, int maxAverageNum = 1000000):
 			capacity_(capacity),
 			minFreq_(INT8_MAX), //minFreq_ֵ, ʴ
 			maxAverageNum_(maxAverageNum),
 			curAverageNum_(0),
-			curTotalNum_(0){}
+			curTotalNum_(0),
+			sampleInterval_(1),
+			sampleState_(reinterpret_cast<uintptr_t>(this) | 1){}
 
 		void put(Key key, Value value) override;
 		bool get(Key key, Value& value) override;
@@ -80,17 +91,30 @@ namespace KamaCache
 		{ return curTotalNum_; }
 		int getAverageFreq() const
 		{ return curAverageNum_; }
-		int nodeFreq(Key key) { return nodeMap_[key]->freq; }
+		int nodeFreq(Key key); //key ʱ 0
+		//ÿ get  1/sampleInterval ĸʲ,  trackedKeys ѡȵ key, ֻͳԼ windowSeconds 
+		void enableHotKeyTracking(size_t trackedKeys = 64, int sampleInterval = 16, double windowSeconds = 10.0);
+		std::vector<KHotKey<Key>> hotKeys(size_t k);
+		double requestRate(); //Ƶһÿ get 
+		void resetHotKeys();
+		bool peek(Key key, Value& value); //ֻȡƵ
+		void putCold(Key key, Value value); //½ڵ嵽 freq=1 ͷ(̭), Ѵֵֻ
+		bool pin(Key key); //ס󲻻ᱻ̭, ռ
+		bool unpin(Key key);
 	private:
 		// void putInternal(Key key, Value value);
 		// void getInternal(NodePtr node, Value& value);
 		// void kickOut();
+		void addNewNode(const Key& key, const Value& value, bool cold);
+		void increaseFreq(NodePtr node); //Ƶ+1ƵӦfreqList
+		NodePtr pickVictim(); //minFreq_ סΪ, ʱ¼; Ϊ(ȫס)ŷؿ
 		void removeFromFreqList(NodePtr node);
 		void addToFreqList(NodePtr node);
 		void addFreqNum();
 		void decreaseFreqNum(int num);
 		void handleOverMaxAverageNum();
 		void updateMinFreq();
+		void sampleHotKey(const Key& key);
 	};
 
 	template<typename Key, typename Value>
@@ -118,6 +142,15 @@ namespace KamaCache
 		Value get(Key key);
 		bool get(Key key, Value& value);
 		void purge();
+		void enableHotKeyTracking(size_t trackedKeys = 64, int sampleInterval = 16, double windowSeconds = 10.0);
+		std::vector<KHotKey<Key>> sliceHotKeys(int sliceIndex, size_t k);
+		std::vector<KHotKey<Key>> hotKeys(size_t k); //Ƭ key ص, ϲȡȫ top-k
+		std::vector<double> sliceRequestRates(); //ڷַƬز
+		void resetHotKeys();
+		bool peek(Key key, Value& value);
+		void putCold(Key key, Value value);
+		bool pin(Key key);
+		bool unpin(Key key);
 	private:
 		size_t Hash(Key key);
 
@@ -158,6 +191,18 @@ namespace KamaCache
 		node->next = nullptr;
 	}
 
+	template <typename Key, typename Value>
+	void FreqList<Key, Value>::addNodeToHead(NodePtr node)
+	{
+		if (!node || !head_ || !tail_)
+			return;
+		NodePtr next = head_->next;
+		node->next = next;
+		node->pre = head_;
+		next->pre = node;
+		head_->next = node;
+	}
+
 	template <typename Key, typename Value>
 	typename FreqList<Key, Value>::NodePtr FreqList<Key, Value>::getFirstNode() const
 	{
@@ -175,6 +220,11 @@ namespace KamaCache
 	{
 		if (capacity_ == 0)
 			return;
+		if (KScanModeGuard::active())
+		{
+			putCold(key, value);
+			return;
+		}
 		std::lock_guard<std::mutex> lock(mutex_);
 		auto it = nodeMap_.find(key);
 		//ҵkey, ֵ, freqList
@@ -182,39 +232,17 @@ namespace KamaCache
 		{
 			NodePtr node = it->second;
 			node->value = value; //ֵ
-			//Ƶ
-			removeFromFreqList(node); //ȴԭλƳڵ
-			++node->freq;
-			addToFreqList(node); //ӽµfreqList
-			if (freqToFreqList_[node->freq - 1]->isEmpty() && minFreq_ == node->freq-1)
-			{
-				freqToFreqList_.erase(node->freq - 1);
-				minFreq_ = node->freq;
-			}
-			addFreqNum();
+			increaseFreq(node); //Ƶ
 			return;
 		}
-
-		//δҵ, ȼ黺Ƿ, ̭ڵ, ӽڵ, FreqNum
-		if (nodeMap_.size() == capacity_)
-		{
-			NodePtr node = freqToFreqList_[minFreq_]->getFirstNode();
-			removeFromFreqList(node);
-			nodeMap_.erase(node->key);
-			decreaseFreqNum(node->freq);
-		}
-		//ӽڵ, FreqNum
-		NodePtr newNode = std::make_shared<Node>(key, value);
-		nodeMap_[key] = newNode;
-		addToFreqList(newNode);
-		addFreqNum();
-		minFreq_ = 1;
-		return;
+		addNewNode(key, value, false);
 	}
 
 	template <typename Key, typename Value>
 	bool KLfuCache<Key, Value>::get(Key key, Value& value)
 	{
+		if (KScanModeGuard::active())
+			return peek(key, value);
 		std::lock_guard<std::mutex> lock(mutex_);
 		//ҵڵ, ƶkey, FreqNum
 		auto it = nodeMap_.find(key);
@@ -222,17 +250,11 @@ namespace KamaCache
 		{
 			NodePtr node = it->second;
 			value = node->value;
-			removeFromFreqList(node);
-			node->freq++;
-			addToFreqList(node);
-			if (freqToFreqList_[node->freq-1]->isEmpty() && minFreq_ == node->freq-1)
-			{
-				freqToFreqList_.erase(node->freq - 1);
-				minFreq_ = node->freq;
-			}
-			addFreqNum();
+			increaseFreq(node);
+			sampleHotKey(key);
 			return true;
 		}
+		sampleHotKey(key); //δеȵ key ͬѹƬ
 		return false;
 	}
 
@@ -251,6 +273,188 @@ namespace KamaCache
 		freqToFreqList_.clear();
 	}
 
+	template <typename Key, typename Value>
+	int KLfuCache<Key, Value>::nodeFreq(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it == nodeMap_.end())
+			return 0;
+		return it->second->freq;
+	}
+
+	template <typename Key, typename Value>
+	void KLfuCache<Key, Value>::enableHotKeyTracking(size_t trackedKeys, int sampleInterval, double windowSeconds)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		hotKeys_ = std::make_unique<KHotKeyWindow<Key>>(trackedKeys, windowSeconds);
+		sampleInterval_ = sampleInterval > 0 ? sampleInterval : 1;
+	}
+
+	template <typename Key, typename Value>
+	std::vector<KHotKey<Key>> KLfuCache<Key, Value>::hotKeys(size_t k)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!hotKeys_)
+			return std::vector<KHotKey<Key>>();
+		return hotKeys_->topK(k);
+	}
+
+	template <typename Key, typename Value>
+	double KLfuCache<Key, Value>::requestRate()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!hotKeys_)
+			return 0;
+		return hotKeys_->getTotalRate();
+	}
+
+	template <typename Key, typename Value>
+	void KLfuCache<Key, Value>::resetHotKeys()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (hotKeys_)
+			hotKeys_->reset();
+	}
+
+	template <typename Key, typename Value>
+	void KLfuCache<Key, Value>::sampleHotKey(const Key& key)
+	{
+		//÷ѳ mutex_, ʱȨ, ʵʴ
+		if (!hotKeys_)
+			return;
+		sampleState_ ^= sampleState_ << 13;
+		sampleState_ ^= sampleState_ >> 7;
+		sampleState_ ^= sampleState_ << 17;
+		if (sampleState_ % sampleInterval_ != 0)
+			return;
+		hotKeys_->offer(key, sampleInterval_);
+	}
+
+	template <typename Key, typename Value>
+	bool KLfuCache<Key, Value>::peek(Key key, Value& value)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it == nodeMap_.end())
+			return false;
+		value = it->second->value;
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	void KLfuCache<Key, Value>::putCold(Key key, Value value)
+	{
+		if (capacity_ == 0)
+			return;
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it != nodeMap_.end())
+		{
+			it->second->value = value;
+			return;
+		}
+		addNewNode(key, value, true);
+	}
+
+	template <typename Key, typename Value>
+	bool KLfuCache<Key, Value>::pin(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it == nodeMap_.end())
+			return false;
+		NodePtr node = it->second;
+		if (!node->pinned)
+		{
+			removeFromFreqList(node); //ƳfreqList, ֻ̭freqList, ɨ
+			node->pinned = true;
+		}
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	bool KLfuCache<Key, Value>::unpin(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it == nodeMap_.end())
+			return false;
+		NodePtr node = it->second;
+		if (node->pinned)
+		{
+			node->pinned = false;
+			addToFreqList(node);
+			if (node->freq < minFreq_)
+				minFreq_ = node->freq;
+		}
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	void KLfuCache<Key, Value>::addNewNode(const Key& key, const Value& value, bool cold)
+	{
+		//ȼ黺Ƿ, ̭ڵ, ӽڵ, FreqNum
+		if (nodeMap_.size() >= capacity_)
+		{
+			NodePtr node = pickVictim();
+			if (!node)
+				return; //ȫס, 
+			removeFromFreqList(node);
+			nodeMap_.erase(node->key);
+			decreaseFreqNum(node->freq);
+		}
+		//ӽڵ, FreqNum
+		NodePtr newNode = std::make_shared<Node>(key, value);
+		nodeMap_[key] = newNode;
+		if (cold)
+		{
+			if (freqToFreqList_.find(newNode->freq) == freqToFreqList_.end())
+				freqToFreqList_[newNode->freq] = std::make_shared<FreqList<Key, Value>>(newNode->freq);
+			freqToFreqList_[newNode->freq]->addNodeToHead(newNode);
+		}
+		else
+		{
+			addToFreqList(newNode);
+		}
+		addFreqNum();
+		minFreq_ = 1;
+	}
+
+	template <typename Key, typename Value>
+	void KLfuCache<Key, Value>::increaseFreq(NodePtr node)
+	{
+		if (node->pinned)
+		{
+			++node->freq;
+			addFreqNum();
+			return;
+		}
+		removeFromFreqList(node); //ȴԭλƳڵ
+		++node->freq;
+		addToFreqList(node); //ӽµfreqList
+		if (freqToFreqList_[node->freq - 1]->isEmpty() && minFreq_ == node->freq - 1)
+		{
+			freqToFreqList_.erase(node->freq - 1);
+			minFreq_ = node->freq;
+		}
+		addFreqNum();
+	}
+
+	template <typename Key, typename Value>
+	typename KLfuCache<Key, Value>::NodePtr KLfuCache<Key, Value>::pickVictim()
+	{
+		auto it = freqToFreqList_.find(minFreq_);
+		if (it == freqToFreqList_.end() || !it->second || it->second->isEmpty())
+		{
+			updateMinFreq(); //ֻƵ, ڵ
+			it = freqToFreqList_.find(minFreq_);
+			if (it == freqToFreqList_.end() || !it->second || it->second->isEmpty())
+				return nullptr;
+		}
+		return it->second->getFirstNode();
+	}
+
 	template <typename Key, typename Value>
 	void KLfuCache<Key, Value>::removeFromFreqList(NodePtr node)
 	{
@@ -306,10 +510,12 @@ namespace KamaCache
 			if (!it->second)
 				continue;
 			NodePtr node = it->second;
-			removeFromFreqList(node); 
+			if (!node->pinned)
+				removeFromFreqList(node); 
 			node->freq -= maxAverageNum_ / 2;
 			if (node->freq < 1) node->freq = 1;
-			addToFreqList(node);
+			if (!node->pinned)
+				addToFreqList(node);
 		}
 		updateMinFreq();
 	}
@@ -317,13 +523,17 @@ namespace KamaCache
 	template <typename Key, typename Value>
 	void KLfuCache<Key, Value>::updateMinFreq()
 	{
-		minFreq_ = INT8_MAX;
+		//ȡǿʵСƵ, Ƶοܳ INT8_MAX, ڱ; ȫΪʱ 1
+		bool found = false;
 		for (const auto& pair : freqToFreqList_)
 		{
-			if (pair.second && !pair.second->isEmpty())
-				minFreq_ = std::min(minFreq_, pair.first);
+			if (pair.second && !pair.second->isEmpty() && (!found || pair.first < minFreq_))
+			{
+				minFreq_ = pair.first;
+				found = true;
+			}
 		}
-		if (minFreq_ == INT8_MAX)
+		if (!found)
 			minFreq_ = 1;
 	}
 
@@ -357,6 +567,82 @@ namespace KamaCache
 			lfuSliceCache->purge();
 	}
 
+	template <typename Key, typename Value>
+	void KHashLfuCache<Key, Value>::enableHotKeyTracking(size_t trackedKeys, int sampleInterval, double windowSeconds)
+	{
+		for (auto& lfuSliceCache : lfuSliceCaches_)
+			lfuSliceCache->enableHotKeyTracking(trackedKeys, sampleInterval, windowSeconds);
+	}
+
+	template <typename Key, typename Value>
+	std::vector<KHotKey<Key>> KHashLfuCache<Key, Value>::sliceHotKeys(int sliceIndex, size_t k)
+	{
+		std::vector<KHotKey<Key>> result = lfuSliceCaches_[sliceIndex]->hotKeys(k);
+		for (auto& hotKey : result)
+			hotKey.sliceIndex = sliceIndex;
+		return result;
+	}
+
+	template <typename Key, typename Value>
+	std::vector<KHotKey<Key>> KHashLfuCache<Key, Value>::hotKeys(size_t k)
+	{
+		std::vector<KHotKey<Key>> result;
+		for (int i = 0; i < static_cast<int>(lfuSliceCaches_.size()); i++)
+		{
+			std::vector<KHotKey<Key>> sliceResult = sliceHotKeys(i, k);
+			result.insert(result.end(), sliceResult.begin(), sliceResult.end());
+		}
+		k = std::min(k, result.size());
+		std::partial_sort(result.begin(), result.begin() + k, result.end(),
+			[](const KHotKey<Key>& a, const KHotKey<Key>& b) { return a.count > b.count; });
+		result.resize(k);
+		return result;
+	}
+
+	template <typename Key, typename Value>
+	std::vector<double> KHashLfuCache<Key, Value>::sliceRequestRates()
+	{
+		std::vector<double> rates;
+		for (auto& lfuSliceCache : lfuSliceCaches_)
+			rates.push_back(lfuSliceCache->requestRate());
+		return rates;
+	}
+
+	template <typename Key, typename Value>
+	void KHashLfuCache<Key, Value>::resetHotKeys()
+	{
+		for (auto& lfuSliceCache : lfuSliceCaches_)
+			lfuSliceCache->resetHotKeys();
+	}
+
+	template <typename Key, typename Value>
+	bool KHashLfuCache<Key, Value>::peek(Key key, Value& value)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		return lfuSliceCaches_[sliceIndex]->peek(key, value);
+	}
+
+	template <typename Key, typename Value>
+	void KHashLfuCache<Key, Value>::putCold(Key key, Value value)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		lfuSliceCaches_[sliceIndex]->putCold(key, value);
+	}
+
+	template <typename Key, typename Value>
+	bool KHashLfuCache<Key, Value>::pin(Key key)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		return lfuSliceCaches_[sliceIndex]->pin(key);
+	}
+
+	template <typename Key, typename Value>
+	bool KHashLfuCache<Key, Value>::unpin(Key key)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		return lfuSliceCaches_[sliceIndex]->unpin(key);
+	}
+
 	template <typename Key, typename Value>
 	size_t KHashLfuCache<Key, Value>::Hash(Key key)
 	{
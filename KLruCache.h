@@ -1,7 +1,12 @@
 #pragma once
 #include "KICachePolicy.h"
+#include "KAccessHint.h"
+#include "KCompactLruCache.h"
+#include <cmath>
 #include <memory>
 #include <mutex> //
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -12,14 +17,14 @@ namespace KamaCache
 	template <typename Key, typename Value>
 	class KLruCache;
 
-	//LruNodeάkey value ʼ ǰָ
+	//LruNodeάkey value ǰָ
 	template <typename Key, typename Value>
 	class LruNode
 	{
 	private:
 		Key key_;
 		Value value_;
-		size_t accessCount_;
+		bool pinned_; //סĽڵ㲻, ̭ʱȻ
 		std::weak_ptr<LruNode<Key, Value>> prev_;
 		std::shared_ptr<LruNode<Key, Value>> next_;
 
@@ -27,15 +32,13 @@ namespace KamaCache
 		LruNode(Key key, Value value):
 			key_(key),
 			value_(value),
-			accessCount_(1)
+			pinned_(false)
 		{
 		}
 
 		Key getKey() const { return key_; }
 		Value getValue() const { return value_; }
 		void setValue(const Value& value) { value_ = value; }
-		size_t getAccessCount() const { return accessCount_; }
-		void incrementAccessCount() { ++accessCount_; }
 
 		friend class KLruCache<Key, Value>;
 	};
@@ -67,14 +70,19 @@ namespace KamaCache
 		bool get(Key key, Value& value) override; //key
 		Value get(Key key) override;
 		void remove(Key key); //ȥkeyӦڵ
+		bool peek(Key key, Value& value); //ֻȡƶβ
+		void putCold(Key key, Value value); //½ڵ嵽ͷ(̭), Ѵֵֻ
+		bool pin(Key key); //ס󲻻ᱻ̭, ռ
+		bool unpin(Key key); //ס, ڵصβ
 	private:
 		void initializeList(); //ʼͷβڵ 
 		void updateExistingNode(NodePtr node, const Value& value); //½ڵ
-		void addNewNode(const Key& key, const Value& value); //½ڵ
+		void addNewNode(const Key& key, const Value& value, bool cold = false); //½ڵ
 		void moveToMostRecent(NodePtr node); //Ƴڵ, ½ڵ嵽β
 		void removeNode(NodePtr node); //Ƴǰڵ, Ƴɾ
 		void insertNode(NodePtr node); //ڽڵƶβ
-		void evictLeastRecent(); //ɾڵ, nodeMap_лһɾ
+		void insertNodeAtHead(NodePtr node);
+		bool evictLeastRecent(); //ɾڵ, nodeMap_лһɾ, ȫסʱfalse
 	};
 
 	//public
@@ -83,6 +91,11 @@ namespace KamaCache
 	{
 		if (capacity_ <= 0)
 			return;
+		if (KScanModeGuard::active())
+		{
+			putCold(key, value);
+			return;
+		}
 		std::lock_guard<std::mutex> lock(mutex_);
 		auto it = nodeMap_.find(key);
 		if (it != nodeMap_.end())
@@ -98,6 +111,8 @@ namespace KamaCache
 	template <typename Key, typename Value>
 	bool KLruCache<Key, Value>::get(Key key, Value& value)
 	{
+		if (KScanModeGuard::active())
+			return peek(key, value);
 		std::lock_guard<std::mutex> lock(mutex_); //mutex_˽гԱ, lockԶ, 
 		auto it = nodeMap_.find(key);
 		if (it != nodeMap_.end())
@@ -130,6 +145,66 @@ namespace KamaCache
 		}
 	}
 
+	template <typename Key, typename Value>
+	bool KLruCache<Key, Value>::peek(Key key, Value& value)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it != nodeMap_.end())
+		{
+			value = it->second->getValue();
+			return true;
+		}
+		return false;
+	}
+
+	template <typename Key, typename Value>
+	void KLruCache<Key, Value>::putCold(Key key, Value value)
+	{
+		if (capacity_ <= 0)
+			return;
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it != nodeMap_.end())
+		{
+			it->second->setValue(value);
+		}
+		else
+		{
+			addNewNode(key, value, true);
+		}
+	}
+
+	template <typename Key, typename Value>
+	bool KLruCache<Key, Value>::pin(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it == nodeMap_.end())
+			return false;
+		if (!it->second->pinned_)
+		{
+			removeNode(it->second); //Ƴ, ֻ̭, ɨ
+			it->second->pinned_ = true;
+		}
+		return true;
+	}
+
+	template <typename Key, typename Value>
+	bool KLruCache<Key, Value>::unpin(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = nodeMap_.find(key);
+		if (it == nodeMap_.end())
+			return false;
+		if (it->second->pinned_)
+		{
+			it->second->pinned_ = false;
+			insertNode(it->second);
+		}
+		return true;
+	}
+
 	//private
 	template <typename Key, typename Value>
 	void KLruCache<Key, Value>::initializeList()
@@ -149,20 +224,26 @@ namespace KamaCache
 	}
 
 	template <typename Key, typename Value>
-	void KLruCache<Key, Value>::addNewNode(const Key& key, const Value& value)
+	void KLruCache<Key, Value>::addNewNode(const Key& key, const Value& value, bool cold)
 	{
 		if (nodeMap_.size() >= capacity_)
 		{
-			evictLeastRecent();
+			if (!evictLeastRecent())
+				return; //ȫס, 
 		}
 		NodePtr newNode = std::make_shared<LruNodeType>(key, value);
-		insertNode(newNode);
+		if (cold)
+			insertNodeAtHead(newNode);
+		else
+			insertNode(newNode);
 		nodeMap_[key] = newNode;
 	}
 
 	template <typename Key, typename Value>
 	void KLruCache<Key, Value>::moveToMostRecent(NodePtr node)
 	{
+		if (node->pinned_)
+			return;
 		removeNode(node);
 		insertNode(node);
 	}
@@ -192,11 +273,23 @@ namespace KamaCache
 	}
 
 	template <typename Key, typename Value>
-	void KLruCache<Key, Value>::evictLeastRecent()
+	void KLruCache<Key, Value>::insertNodeAtHead(NodePtr node)
+	{
+		node->next_ = dummyHead_->next_;
+		node->prev_ = dummyHead_;
+		dummyHead_->next_->prev_ = node;
+		dummyHead_->next_ = node;
+	}
+
+	template <typename Key, typename Value>
+	bool KLruCache<Key, Value>::evictLeastRecent()
 	{
 		NodePtr leastRecent = dummyHead_->next_;
+		if (leastRecent == dummyTail_)
+			return false;
 		removeNode(leastRecent);
 		nodeMap_.erase(leastRecent->getKey());
+		return true;
 	}
 
 
@@ -281,14 +374,19 @@ namespace KamaCache
 
 
 
-	//KHashLruCaches----------ԻƬ, ֱӰ(ʹ)KLruCache
+	//Ƭ: СĿƽ KCompactLruCache,  KLruCache
 	template <typename Key, typename Value>
+	using KLruSlice = typename std::conditional<KUseCompactLayout<Key, Value>::value,
+		KCompactLruCache<Key, Value>, KLruCache<Key, Value>>::type;
+
+	//KHashLruCaches----------ԻƬ, ֱӰ(ʹ)KLruCache
+	template <typename Key, typename Value, typename SliceCache = KLruSlice<Key, Value>>
 	class KHashLruCaches
 	{
 	private:
 		size_t capacity_;	//
 		int sliceNum_;	//Ƭ
-		std::vector<std::unique_ptr<KLruCache<Key, Value>>> lruSliceCaches_; //KLruCache ָʸ
+		std::vector<std::unique_ptr<SliceCache>> lruSliceCaches_; //Ƭָʸ
 	private:
 		size_t Hash(Key key);
 	public:
@@ -300,45 +398,77 @@ namespace KamaCache
 			for (int i = 0; i < sliceNum_; i++)
 			{
 				//ʼvector, ÿcachesliceSize
-				lruSliceCaches_.emplace_back(std::make_unique<KLruCache<Key, Value>>(sliceSize));
+				lruSliceCaches_.emplace_back(std::make_unique<SliceCache>(sliceSize));
 			}
 		}
 		void put(Key key, Value value);
 		bool get(Key key, Value& value);
 		Value get(Key key);
+		bool peek(Key key, Value& value);
+		void putCold(Key key, Value value);
+		bool pin(Key key);
+		bool unpin(Key key);
 		int getSliceNum() const
 		{
 			return sliceNum_;
 		}
 	};
 
-	template <typename Key, typename Value>
-	size_t KHashLruCaches<Key, Value>::Hash(Key key)
+	template <typename Key, typename Value, typename SliceCache>
+	size_t KHashLruCaches<Key, Value, SliceCache>::Hash(Key key)
 	{
 		std::hash<Key> hashFunc;
 		return hashFunc(key); //key㷵عϣֵ
 	}
 
-	template <typename Key, typename Value>
-	void KHashLruCaches<Key, Value>::put(Key key, Value value)
+	template <typename Key, typename Value, typename SliceCache>
+	void KHashLruCaches<Key, Value, SliceCache>::put(Key key, Value value)
 	{
 		size_t sliceIndex = Hash(key) % sliceNum_; //ʹhashӳ䵽vectorƬ
 		lruSliceCaches_[sliceIndex]->put(key, value);
 	}
 
-	template <typename Key, typename Value>
-	bool KHashLruCaches<Key, Value>::get(Key key, Value& value)
+	template <typename Key, typename Value, typename SliceCache>
+	bool KHashLruCaches<Key, Value, SliceCache>::get(Key key, Value& value)
 	{
 		size_t sliceIndex = Hash(key) % sliceNum_; //
 		bool inCache = lruSliceCaches_[sliceIndex]->get(key, value);
 		return inCache;
 	}
 
-	template <typename Key, typename Value>
-	Value KHashLruCaches<Key, Value>::get(Key key)
+	template <typename Key, typename Value, typename SliceCache>
+	Value KHashLruCaches<Key, Value, SliceCache>::get(Key key)
 	{
 		Value value;
 		get(key, value);
 		return value;
 	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	bool KHashLruCaches<Key, Value, SliceCache>::peek(Key key, Value& value)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		return lruSliceCaches_[sliceIndex]->peek(key, value);
+	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	void KHashLruCaches<Key, Value, SliceCache>::putCold(Key key, Value value)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		lruSliceCaches_[sliceIndex]->putCold(key, value);
+	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	bool KHashLruCaches<Key, Value, SliceCache>::pin(Key key)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		return lruSliceCaches_[sliceIndex]->pin(key);
+	}
+
+	template <typename Key, typename Value, typename SliceCache>
+	bool KHashLruCaches<Key, Value, SliceCache>::unpin(Key key)
+	{
+		size_t sliceIndex = Hash(key) % sliceNum_;
+		return lruSliceCaches_[sliceIndex]->unpin(key);
+	}
 };
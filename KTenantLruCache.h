@@ -0,0 +1,518 @@
+#pragma once
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace KamaCache
+{
+	//⻧ LRU: ͬһƬڰ⻧ key, ÿ⻧С
+	//ͱ⻧зƬϵռж, ռǸƬԭӼ, дҪȫ
+	//ÿƬά⻧/δм, ͳʱƬ
+	//⻧ͨ setTenantQuota  put Ǽǵ KTenantRegistry, get ֻҲǼ; δǼ⻧δе
+
+	using TenantId = int;
+
+	template <typename Key>
+	struct TenantKey
+	{
+		TenantId tenant;
+		Key key;
+		bool operator==(const TenantKey& other) const
+		{
+			return tenant == other.tenant && key == other.key;
+		}
+	};
+
+	template <typename Key>
+	struct TenantKeyHash
+	{
+		size_t operator()(const TenantKey<Key>& tenantKey) const
+		{
+			size_t h = std::hash<Key>()(tenantKey.key);
+			return h ^ (std::hash<TenantId>()(tenantKey.tenant) + 0x9e3779b9 + (h << 6) + (h >> 2));
+		}
+	};
+
+	//⻧ͳ, ƬΪ÷Ƭ, ƬܺΪȫ
+	struct KTenantStats
+	{
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t size = 0;	//ǰռĿ
+		size_t evictions = 0;	//⻧̭Ŀ
+	};
+
+	//⻧淶Χڵռ, ɸƬ, ԭӱֻ relaxed д
+	struct KTenantShared
+	{
+		std::atomic<size_t> minSize;	//, ռòʱᱻ⻧
+		std::atomic<size_t> maxSize;	//, ռôﵽ̭⻧ԼĿ
+		std::atomic<size_t> size;	//зƬϵռ
+
+		explicit KTenantShared(size_t defaultMaxSize): minSize(0), maxSize(defaultMaxSize), size(0) {}
+	};
+
+	//⻧ǼǱ, ֻڷƬһμĳ⻧ʱ, ֮Ƭֱӳ KTenantShared ָ
+	class KTenantRegistry
+	{
+	private:
+		size_t defaultMaxSize_;	//δ⻧ռ
+		std::mutex mutex_;
+		std::unordered_map<TenantId, std::unique_ptr<KTenantShared>> tenants_;
+		std::atomic<size_t> unknownMisses_;	//δǼ⻧δд
+	public:
+		explicit KTenantRegistry(size_t defaultMaxSize): defaultMaxSize_(defaultMaxSize), unknownMisses_(0) {}
+
+		KTenantShared* find(TenantId tenant)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto it = tenants_.find(tenant);
+			return it == tenants_.end() ? nullptr : it->second.get();
+		}
+
+		KTenantShared* findOrCreate(TenantId tenant)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::unique_ptr<KTenantShared>& shared = tenants_[tenant];
+			if (!shared)
+				shared = std::make_unique<KTenantShared>(defaultMaxSize_);
+			return shared.get();
+		}
+
+		void setQuota(TenantId tenant, size_t minSize, size_t maxSize)
+		{
+			KTenantShared* shared = findOrCreate(tenant);
+			shared->minSize.store(minSize, std::memory_order_relaxed);
+			shared->maxSize.store(maxSize, std::memory_order_relaxed);
+		}
+
+		std::vector<TenantId> tenants()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::vector<TenantId> result;
+			for (const auto& pair : tenants_)
+				result.push_back(pair.first);
+			return result;
+		}
+
+		void addUnknownMiss() { unknownMisses_.fetch_add(1, std::memory_order_relaxed); }
+		size_t getUnknownMisses() const { return unknownMisses_.load(std::memory_order_relaxed); }
+	};
+
+	template <typename Key, typename Value>
+	class KTenantLruCache;
+
+	template <typename Key, typename Value>
+	class TenantLruNode
+	{
+	private:
+		TenantKey<Key> key_;
+		Value value_;
+		size_t tick_;	//Ƭڵķ, ڱȽϲͬ⻧ͷ˭δ
+		std::weak_ptr<TenantLruNode<Key, Value>> prev_;
+		std::shared_ptr<TenantLruNode<Key, Value>> next_;
+
+	public:
+		TenantLruNode(TenantKey<Key> key, Value value):
+			key_(key),
+			value_(value),
+			tick_(0)
+		{
+		}
+
+		friend class KTenantLruCache<Key, Value>;
+	};
+
+	//Ƭ, ÿ⻧һ LRU 
+	//ʹʱԴǼǱ;  KHashTenantLruCaches ʱƬͬһǼǱ
+	template <typename Key, typename Value>
+	class KTenantLruCache
+	{
+	public:
+		using TenantLruNodeType = TenantLruNode<Key, Value>;
+		using NodePtr = std::shared_ptr<TenantLruNodeType>;
+		using NodeMap = std::unordered_map<TenantKey<Key>, NodePtr, TenantKeyHash<Key>>;
+	private:
+		struct TenantState
+		{
+			KTenantShared* shared;	//ȫռ
+			NodePtr dummyHead;
+			NodePtr dummyTail;
+			KTenantStats stats;	//Ƭļ, size ΪƬڵռ
+		};
+
+		size_t capacity_;
+		size_t tick_;
+		std::unique_ptr<KTenantRegistry> ownedRegistry_;
+		KTenantRegistry* registry_;
+		NodeMap nodeMap_;
+		std::unordered_map<TenantId, TenantState> tenants_;
+		std::mutex mutex_;
+	public:
+		KTenantLruCache(size_t capacity):
+			capacity_(capacity),
+			tick_(0),
+			ownedRegistry_(std::make_unique<KTenantRegistry>(capacity)),
+			registry_(ownedRegistry_.get())
+		{
+		}
+
+		KTenantLruCache(size_t capacity, KTenantRegistry* registry):
+			capacity_(capacity),
+			tick_(0),
+			registry_(registry)
+		{
+		}
+
+		void put(TenantId tenant, Key key, Value value);
+		bool get(TenantId tenant, Key key, Value& value);
+		Value get(TenantId tenant, Key key);
+		void remove(TenantId tenant, Key key);
+		void setTenantQuota(TenantId tenant, size_t minSize, size_t maxSize); //дǼǱ, ԹõǼǱзƬЧ
+		KTenantStats tenantStats(TenantId tenant);
+		std::unordered_map<TenantId, KTenantStats> allTenantStats();
+	private:
+		TenantState* tenantState(TenantId tenant, bool registerTenant); //Ƭûи⻧ʱӵǼǱȡ, registerTenant Ϊ false δǼʱؿ
+		void evictForInsert(TenantId tenant); //Ƭʱѡ̭⻧
+		void evictLeastRecent(TenantState& state);
+		void moveToMostRecent(TenantState& state, NodePtr node);
+		void removeNode(NodePtr node);
+		void insertNode(TenantState& state, NodePtr node);
+	};
+
+	//public
+	template <typename Key, typename Value>
+	void KTenantLruCache<Key, Value>::put(TenantId tenant, Key key, Value value)
+	{
+		if (capacity_ == 0)
+			return;
+		std::lock_guard<std::mutex> lock(mutex_);
+		TenantState& state = *tenantState(tenant, true);
+		auto it = nodeMap_.find(TenantKey<Key>{tenant, key});
+		if (it != nodeMap_.end())
+		{
+			it->second->value_ = value;
+			moveToMostRecent(state, it->second);
+			return;
+		}
+		size_t maxSize = state.shared->maxSize.load(std::memory_order_relaxed);
+		if (maxSize == 0)
+			return;
+
+		//⻧ռôﵽʱ̭ԼڱƬĿ
+		//ƬûĿʱճ, ÿƬһ, ֮ᱻ̭
+		while (state.shared->size.load(std::memory_order_relaxed) >= maxSize && state.stats.size > 0)
+			evictLeastRecent(state);
+		if (nodeMap_.size() >= capacity_)
+			evictForInsert(tenant);
+		NodePtr newNode = std::make_shared<TenantLruNodeType>(TenantKey<Key>{tenant, key}, value);
+		insertNode(state, newNode);
+		nodeMap_[newNode->key_] = newNode;
+		++state.stats.size;
+		state.shared->size.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	template <typename Key, typename Value>
+	bool KTenantLruCache<Key, Value>::get(TenantId tenant, Key key, Value& value)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		//·ֻҲǼ; ƬǼǹ⻧ﲹ״̬, δճ
+		TenantState* state = tenantState(tenant, false);
+		if (state == nullptr)
+		{
+			registry_->addUnknownMiss();
+			return false;
+		}
+		auto it = nodeMap_.find(TenantKey<Key>{tenant, key});
+		if (it != nodeMap_.end())
+		{
+			moveToMostRecent(*state, it->second);
+			value = it->second->value_;
+			++state->stats.hits;
+			return true;
+		}
+		++state->stats.misses;
+		return false;
+	}
+
+	template <typename Key, typename Value>
+	Value KTenantLruCache<Key, Value>::get(TenantId tenant, Key key)
+	{
+		Value value{};
+		get(tenant, key, value);
+		return value;
+	}
+
+	template <typename Key, typename Value>
+	void KTenantLruCache<Key, Value>::remove(TenantId tenant, Key key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto tenantIt = tenants_.find(tenant);
+		if (tenantIt == tenants_.end())
+			return;
+		auto it = nodeMap_.find(TenantKey<Key>{tenant, key});
+		if (it != nodeMap_.end())
+		{
+			removeNode(it->second);
+			nodeMap_.erase(it);
+			--tenantIt->second.stats.size;
+			tenantIt->second.shared->size.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	template <typename Key, typename Value>
+	void KTenantLruCache<Key, Value>::setTenantQuota(TenantId tenant, size_t minSize, size_t maxSize)
+	{
+		//Ĳֲ, ֮ĲȴӸ⻧̭
+		registry_->setQuota(tenant, minSize, maxSize);
+	}
+
+	template <typename Key, typename Value>
+	KTenantStats KTenantLruCache<Key, Value>::tenantStats(TenantId tenant)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = tenants_.find(tenant);
+		if (it == tenants_.end())
+			return KTenantStats();
+		return it->second.stats;
+	}
+
+	template <typename Key, typename Value>
+	std::unordered_map<TenantId, KTenantStats> KTenantLruCache<Key, Value>::allTenantStats()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::unordered_map<TenantId, KTenantStats> result;
+		for (const auto& pair : tenants_)
+			result[pair.first] = pair.second.stats;
+		return result;
+	}
+
+	//private
+	template <typename Key, typename Value>
+	typename KTenantLruCache<Key, Value>::TenantState* KTenantLruCache<Key, Value>::tenantState(TenantId tenant, bool registerTenant)
+	{
+		auto it = tenants_.find(tenant);
+		if (it != tenants_.end())
+			return &it->second;
+		//ÿƬÿ⻧ֻһεǼǱ
+		KTenantShared* shared = registerTenant ? registry_->findOrCreate(tenant) : registry_->find(tenant);
+		if (shared == nullptr)
+			return nullptr;
+		TenantState& state = tenants_[tenant];
+		state.shared = shared;
+		state.dummyHead = std::make_shared<TenantLruNodeType>(TenantKey<Key>{tenant, Key()}, Value());
+		state.dummyTail = std::make_shared<TenantLruNodeType>(TenantKey<Key>{tenant, Key()}, Value());
+		state.dummyHead->next_ = state.dummyTail;
+		state.dummyTail->prev_ = state.dummyHead;
+		return &state;
+	}
+
+	template <typename Key, typename Value>
+	void KTenantLruCache<Key, Value>::evictForInsert(TenantId tenant)
+	{
+		//ȼ: ռó⻧ > ռó⻧, ͬһ̭ͷδʵ
+		//ֻƬĿ⻧Ŀ, Ϊ O(⻧)
+		TenantState* victim = nullptr;
+		bool victimOverQuota = false;
+		for (auto& pair : tenants_)
+		{
+			TenantState& state = pair.second;
+			if (state.stats.size == 0)
+				continue;
+			size_t totalSize = state.shared->size.load(std::memory_order_relaxed);
+			bool overQuota = totalSize > state.shared->maxSize.load(std::memory_order_relaxed);
+			if (!overQuota && totalSize <= state.shared->minSize.load(std::memory_order_relaxed))
+				continue;
+			if (victim == nullptr || (overQuota && !victimOverQuota) ||
+				(overQuota == victimOverQuota && state.dummyHead->next_->tick_ < victim->dummyHead->next_->tick_))
+			{
+				victim = &state;
+				victimOverQuota = overQuota;
+			}
+		}
+
+		//֮ͳʱ, ̭Լ, ˻ΪȫƬδ
+		if (victim == nullptr)
+		{
+			TenantState& self = tenants_.at(tenant);
+			if (self.stats.size > 0)
+				victim = &self;
+		}
+		if (victim == nullptr)
+		{
+			for (auto& pair : tenants_)
+			{
+				TenantState& state = pair.second;
+				if (state.stats.size > 0 &&
+					(victim == nullptr || state.dummyHead->next_->tick_ < victim->dummyHead->next_->tick_))
+					victim = &state;
+			}
+		}
+		if (victim != nullptr)
+			evictLeastRecent(*victim);
+	}
+
+	template <typename Key, typename Value>
+	void KTenantLruCache<Key, Value>::evictLeastRecent(TenantState& state)
+	{
+		NodePtr leastRecent = state.dummyHead->next_;
+		if (leastRecent == state.dummyTail)
+			return;
+		removeNode(leastRecent);
+		nodeMap_.erase(leastRecent->key_);
+		--state.stats.size;
+		++state.stats.evictions;
+		state.shared->size.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	template <typename Key, typename Value>
+	void KTenantLruCache<Key, Value>::moveToMostRecent(TenantState& state, NodePtr node)
+	{
+		removeNode(node);
+		insertNode(state, node);
+	}
+
+	template <typename Key, typename Value>
+	void KTenantLruCache<Key, Value>::removeNode(NodePtr node)
+	{
+		if (!node->prev_.expired() && node->next_)
+		{
+			auto prev = node->prev_.lock();
+			prev->next_ = node->next_;
+			node->next_->prev_ = prev;
+			node->next_ = nullptr;
+			node->prev_.reset();
+		}
+	}
+
+	template <typename Key, typename Value>
+	void KTenantLruCache<Key, Value>::insertNode(TenantState& state, NodePtr node)
+	{
+		node->tick_ = ++tick_;
+		node->next_ = state.dummyTail;
+		node->prev_ = state.dummyTail->prev_;
+		state.dummyTail->prev_.lock()->next_ = node;
+		state.dummyTail->prev_ = node;
+	}
+
+
+	//KHashTenantLruCaches----------⻧Ƭ, зƬһ⻧ǼǱ
+	//ͱ⻧ȫռִ, key ڷƬֲҲȫ
+	//ﵽڷƬûԼĿʱԻ, ռ೬ (Ƭ - 1) , ЩĿᱻ̭
+	template <typename Key, typename Value>
+	class KHashTenantLruCaches
+	{
+	private:
+		size_t capacity_;
+		int sliceNum_;
+		std::unique_ptr<KTenantRegistry> registry_;
+		std::vector<std::unique_ptr<KTenantLruCache<Key, Value>>> tenantSliceCaches_;
+	private:
+		size_t Hash(TenantId tenant, Key key);
+	public:
+		KHashTenantLruCaches(size_t capacity, int sliceNum):
+			capacity_(capacity),
+			sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency()),
+			registry_(std::make_unique<KTenantRegistry>(capacity))
+		{
+			size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_));
+			for (int i = 0; i < sliceNum_; i++)
+			{
+				tenantSliceCaches_.emplace_back(std::make_unique<KTenantLruCache<Key, Value>>(sliceSize, registry_.get()));
+			}
+		}
+		void put(TenantId tenant, Key key, Value value);
+		bool get(TenantId tenant, Key key, Value& value);
+		Value get(TenantId tenant, Key key);
+		void remove(TenantId tenant, Key key);
+		void setTenantQuota(TenantId tenant, size_t minSize, size_t maxSize);
+		KTenantStats tenantStats(TenantId tenant); //Ƭ, ĳһʱ̵ľȷ
+		std::unordered_map<TenantId, KTenantStats> allTenantStats(); //ѵǼ⻧
+		size_t unknownTenantMisses() const { return registry_->getUnknownMisses(); } //δ put ⻧δд
+		int getSliceNum() const
+		{
+			return sliceNum_;
+		}
+	};
+
+	template <typename Key, typename Value>
+	size_t KHashTenantLruCaches<Key, Value>::Hash(TenantId tenant, Key key)
+	{
+		TenantKeyHash<Key> hashFunc;
+		return hashFunc(TenantKey<Key>{tenant, key});
+	}
+
+	template <typename Key, typename Value>
+	void KHashTenantLruCaches<Key, Value>::put(TenantId tenant, Key key, Value value)
+	{
+		size_t sliceIndex = Hash(tenant, key) % sliceNum_;
+		tenantSliceCaches_[sliceIndex]->put(tenant, key, value);
+	}
+
+	template <typename Key, typename Value>
+	bool KHashTenantLruCaches<Key, Value>::get(TenantId tenant, Key key, Value& value)
+	{
+		size_t sliceIndex = Hash(tenant, key) % sliceNum_;
+		return tenantSliceCaches_[sliceIndex]->get(tenant, key, value);
+	}
+
+	template <typename Key, typename Value>
+	Value KHashTenantLruCaches<Key, Value>::get(TenantId tenant, Key key)
+	{
+		Value value{};
+		get(tenant, key, value);
+		return value;
+	}
+
+	template <typename Key, typename Value>
+	void KHashTenantLruCaches<Key, Value>::remove(TenantId tenant, Key key)
+	{
+		size_t sliceIndex = Hash(tenant, key) % sliceNum_;
+		tenantSliceCaches_[sliceIndex]->remove(tenant, key);
+	}
+
+	template <typename Key, typename Value>
+	void KHashTenantLruCaches<Key, Value>::setTenantQuota(TenantId tenant, size_t minSize, size_t maxSize)
+	{
+		registry_->setQuota(tenant, minSize, maxSize);
+	}
+
+	template <typename Key, typename Value>
+	KTenantStats KHashTenantLruCaches<Key, Value>::tenantStats(TenantId tenant)
+	{
+		KTenantStats total;
+		for (auto& tenantSliceCache : tenantSliceCaches_)
+		{
+			KTenantStats stats = tenantSliceCache->tenantStats(tenant);
+			total.hits += stats.hits;
+			total.misses += stats.misses;
+			total.size += stats.size;
+			total.evictions += stats.evictions;
+		}
+		return total;
+	}
+
+	template <typename Key, typename Value>
+	std::unordered_map<TenantId, KTenantStats> KHashTenantLruCaches<Key, Value>::allTenantStats()
+	{
+		std::unordered_map<TenantId, KTenantStats> result;
+		for (TenantId tenant : registry_->tenants())
+			result[tenant];
+		for (auto& tenantSliceCache : tenantSliceCaches_)
+		{
+			for (const auto& pair : tenantSliceCache->allTenantStats())
+			{
+				KTenantStats& total = result[pair.first];
+				total.hits += pair.second.hits;
+				total.misses += pair.second.misses;
+				total.size += pair.second.size;
+				total.evictions += pair.second.evictions;
+			}
+		}
+		return result;
+	}
+}
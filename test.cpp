@@ -1,13 +1,34 @@
 #include "KLruCache.h"
 #include <iostream>
 #include "KLfuCache.h"
+#include "KGdsfCache.h"
+#include "KTenantLruCache.h"
+#include "KAsyncCache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 using KamaCache::KLruCache;
 using KamaCache::KLruKCache;
 using KamaCache::KHashLruCaches;
 using std::cout;
 using std::endl;
 using KamaCache::KLfuCache;
+using KamaCache::KHashLfuCache;
+using KamaCache::KGdsfCache;
+using KamaCache::KHashTenantLruCaches;
+using KamaCache::KHotKey;
+using KamaCache::KScanModeGuard;
+using KamaCache::KAsyncHashCaches;
+using KamaCache::KRunLoop;
+using KamaCache::KTask;
 using std::string;
 
 void printCacheStats(KLfuCache<int, std::string>& cache) {
@@ -17,7 +38,7 @@ void printCacheStats(KLfuCache<int, std::string>& cache) {
     std::cout << "curAverageFreq: " << cache.getAverageFreq() << "\n";
     std::cout << "--------------------\n";
 }
-int main() {
+void testLfuAging() {
     std::cout << "\n========\n";
     KLfuCache<int, std::string> cache(3, 100);  // ƽƵΪ 100
 
@@ -50,5 +71,555 @@ int main() {
     }
 
     std::cout << "\nDone\n";
+}
+
+// ---- ۸֪̭: Ա LRU / LFU / GDSF ʺͽʡδд ----
+struct CostStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    double missCost = 0;   // δʱܺ
+    double savedCost = 0;  // ʡµĴܺ
+};
+
+template <typename GetFn, typename PutFn>
+CostStats runCostTrace(const std::vector<int>& trace, const std::vector<double>& costs, GetFn get, PutFn put) {
+    CostStats stats;
+    int value = 0;
+    for (int key : trace) {
+        if (get(key, value)) {
+            ++stats.hits;
+            stats.savedCost += costs[key];
+        } else {
+            ++stats.misses;
+            stats.missCost += costs[key];
+            put(key, key, costs[key]);
+        }
+    }
+    return stats;
+}
+
+void printCostStats(const char* name, const CostStats& stats) {
+    double total = stats.missCost + stats.savedCost;
+    std::cout << name << "  hitRatio: " << 100.0 * stats.hits / (stats.hits + stats.misses) << "%"
+              << "  missCost: " << stats.missCost
+              << "  savedCost: " << stats.savedCost
+              << " (" << 100.0 * stats.savedCost / total << "%)\n";
+}
+
+void testCostAwareEviction() {
+    std::cout << "\n==== cost aware eviction (GDSF vs LRU vs LFU) ====\n";
+    const int keyNum = 5000;
+    const int capacity = 500;
+    const int ops = 200000;
+
+    // Zipf(0.8) ʷֲ, 10%  key  800ms,  2ms, ȶ޹
+    std::mt19937 rng(42);
+    std::vector<double> cdf(keyNum);
+    double sum = 0;
+    for (int i = 0; i < keyNum; ++i) {
+        sum += 1.0 / std::pow(i + 1, 0.8);
+        cdf[i] = sum;
+    }
+    std::vector<double> costs(keyNum);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (int i = 0; i < keyNum; ++i)
+        costs[i] = uniform(rng) < 0.1 ? 800.0 : 2.0;
+    std::vector<int> trace(ops);
+    for (int i = 0; i < ops; ++i)
+        trace[i] = static_cast<int>(std::lower_bound(cdf.begin(), cdf.end(), uniform(rng) * sum) - cdf.begin());
+
+    KLruCache<int, int> lru(capacity);
+    CostStats lruStats = runCostTrace(trace, costs,
+        [&](int key, int& value) { return lru.get(key, value); },
+        [&](int key, int value, double) { lru.put(key, value); });
+
+    KLfuCache<int, int> lfu(capacity);
+    CostStats lfuStats = runCostTrace(trace, costs,
+        [&](int key, int& value) { return lfu.get(key, value); },
+        [&](int key, int value, double) { lfu.put(key, value); });
+
+    KGdsfCache<int, int> gdsf(capacity);
+    CostStats gdsfStats = runCostTrace(trace, costs,
+        [&](int key, int& value) { return gdsf.get(key, value); },
+        [&](int key, int value, double cost) { gdsf.put(key, value, cost); });
+
+    printCostStats("LRU ", lruStats);
+    printCostStats("LFU ", lfuStats);
+    printCostStats("GDSF", gdsfStats);
+
+    // ±Ŀ²ͬ׼, ѸдԼ̭
+    KGdsfCache<int, int> small(3);
+    small.put(1, 1, 1.0);
+    small.put(2, 2, 5.0);
+    small.put(3, 3, 5.0);
+    small.put(1, 10, 1.0, 2);
+    int value = 0;
+    std::cout << "grow update keeps key 1: " << (small.get(1, value) && value == 10 ? "yes" : "no")
+              << "  usedSize: " << small.getUsedSize() << "\n";
+
+    // ֵʱ, ֵҲٷ
+    bool admitted = small.put(1, 20, 1.0, 4);
+    std::cout << "oversize update admitted: " << (admitted ? "yes" : "no")
+              << "  key 1 still cached: " << (small.get(1, value) ? "yes" : "no")
+              << "  usedSize: " << small.getUsedSize() << "\n";
+}
+
+// ---- ⻧: ⻧ɨ key ʱ, ⻧Ĺ ----
+void testTenantQuota() {
+    std::cout << "\n==== tenant quota (one shared sharded cache) ====\n";
+    const int capacity = 1000;
+    const int sliceNum = 4;
+    const int onlineTenant = 1;
+    const int batchTenant = 2;
+    const int workingSet = 300;
+
+    auto runOnlineRound = [&](auto& getFn) {
+        int hits = 0;
+        for (int key = 0; key < workingSet; ++key)
+            hits += getFn(key) ? 1 : 0;
+        return 100.0 * hits / workingSet;
+    };
+
+    // : ͨƬ LRU, ⻧ key ռ( key ƫ)
+    KHashLruCaches<int, int> shared(capacity, sliceNum);
+    for (int key = 0; key < workingSet; ++key)
+        shared.put(key, key);
+    for (int key = 0; key < 10000; ++key)
+        shared.put(1000000 + key, key);
+    int value = 0;
+    auto sharedGet = [&](int key) { return shared.get(key, value); };
+    std::cout << "KHashLruCaches         online hit ratio after batch scan: " << runOnlineRound(sharedGet) << "%\n";
+
+    // ⻧: ⻧ 400 , ⻧ 500 
+    KHashTenantLruCaches<int, int> tenants(capacity, sliceNum);
+    tenants.setTenantQuota(onlineTenant, 400, capacity);
+    tenants.setTenantQuota(batchTenant, 0, 500);
+    for (int key = 0; key < workingSet; ++key)
+        tenants.put(onlineTenant, key, key);
+    for (int key = 0; key < 10000; ++key) {
+        if (!tenants.get(batchTenant, key, value))
+            tenants.put(batchTenant, key, key);
+    }
+    auto tenantGet = [&](int key) { return tenants.get(onlineTenant, key, value); };
+    std::cout << "KHashTenantLruCaches   online hit ratio after batch scan: " << runOnlineRound(tenantGet) << "%\n";
+
+    for (const auto& pair : tenants.allTenantStats()) {
+        std::cout << "tenant " << pair.first << "  size: " << pair.second.size
+                  << "  hits: " << pair.second.hits << "  misses: " << pair.second.misses
+                  << "  evictions: " << pair.second.evictions << "\n";
+    }
+
+    // Ƭ: ڵ⻧, ͺ󳬶⻧ʹշʹҲȱ̭
+    const int reservedTenant = 3;
+    const int hotTenant = 4;
+    const int newTenant = 5;
+    KHashTenantLruCaches<int, int> full(40, 2);
+    full.setTenantQuota(reservedTenant, 20, 40);
+    for (int key = 0; key < 10; ++key)
+        full.put(reservedTenant, key, key);
+    for (int key = 0; key < 30; ++key)
+        full.put(hotTenant, key, key);
+    for (int key = 0; key < 10; ++key)
+        full.put(newTenant, key, key);
+    std::cout << "after filling  reserved: " << full.tenantStats(reservedTenant).size
+              << "  hot: " << full.tenantStats(hotTenant).size
+              << "  new: " << full.tenantStats(newTenant).size << "\n";
+    full.setTenantQuota(hotTenant, 0, 4);
+    for (int key = 0; key < 30; ++key)
+        full.get(hotTenant, key, value);
+    for (int key = 10; key < 20; ++key)
+        full.put(newTenant, key, key);
+    std::cout << "after quota 4  reserved: " << full.tenantStats(reservedTenant).size
+              << "  hot: " << full.tenantStats(hotTenant).size
+              << "  new: " << full.tenantStats(newTenant).size << "\n";
+
+    // δǼ⻧Ķ״̬
+    for (int tenant = 100; tenant < 10100; ++tenant)
+        full.get(tenant, 0, value);
+    std::cout << "tenants after 10000 unknown-tenant misses: " << full.allTenantStats().size()
+              << "  unknown-tenant misses: " << full.unknownTenantMisses() << "\n";
+
+    // ȫռִ: СڷƬʱ, ÿ key Կɻ
+    const int smallTenant = 6;
+    KHashTenantLruCaches<int, int> spread(100, 4);
+    spread.setTenantQuota(smallTenant, 0, 2);
+    int smallHits = 0;
+    for (int key = 0; key < 8; ++key) {
+        spread.put(smallTenant, key, key);
+        smallHits += spread.get(smallTenant, key, value) ? 1 : 0;
+    }
+    std::cout << "quota 2 on 4 slices  put-then-get hits: " << smallHits << "/8"
+              << "  size: " << spread.tenantStats(smallTenant).size << "\n";
+
+    // ֻ put һε⻧, Ƭϵδͬ
+    const int putOnlyTenant = 7;
+    spread.put(putOnlyTenant, 0, 0);
+    for (int key = 1; key < 100; ++key)
+        spread.get(putOnlyTenant, key, value);
+    std::cout << "put-registered tenant misses: " << spread.tenantStats(putOnlyTenant).misses << "/99\n";
+}
+
+// ---- ȵ key : һ key ռ 30% , ۲ top-k Ƭ ----
+void testHotKeys() {
+    std::cout << "\n==== hot key detection (KHashLfuCache) ====\n";
+    const int sliceNum = 4;
+    const int celebrityKey = 4242;
+    KHashLfuCache<int, int> cache(1000, sliceNum);
+    cache.enableHotKeyTracking(32, 8);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> uniformKey(0, 9999);
+    std::uniform_int_distribution<int> percent(0, 99);
+    int value = 0;
+    for (int i = 0; i < 200000; ++i) {
+        int key = percent(rng) < 30 ? celebrityKey : (percent(rng) < 50 ? uniformKey(rng) % 20 : uniformKey(rng));
+        if (!cache.get(key, value))
+            cache.put(key, key);
+    }
+
+    for (const auto& hotKey : cache.hotKeys(5)) {
+        std::cout << "key " << hotKey.key << "  slice: " << hotKey.sliceIndex
+                  << "  count: " << hotKey.count << " (error <= " << hotKey.error << ")"
+                  << "  rate: " << static_cast<size_t>(hotKey.rate) << "/s\n";
+    }
+    std::vector<double> rates = cache.sliceRequestRates();
+    for (int i = 0; i < sliceNum; ++i)
+        std::cout << "slice " << i << "  rate: " << static_cast<size_t>(rates[i]) << "/s\n";
+
+    // ͳưڻ: ȵں, ȵ㲻Ҫ׷ϾɵۼƼܳ top-K
+    KHashLfuCache<int, int> windowed(1000, sliceNum);
+    windowed.enableHotKeyTracking(32, 8, 0.2);
+    const int oldCelebrity = 1111;
+    const int newCelebrity = 2222;
+    for (int i = 0; i < 200000; ++i)
+        windowed.get(percent(rng) < 30 ? oldCelebrity : uniformKey(rng), value);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    for (int i = 0; i < 20000; ++i)
+        windowed.get(percent(rng) < 30 ? newCelebrity : uniformKey(rng), value);
+    std::vector<KHotKey<int>> recent = windowed.hotKeys(1);
+    std::cout << "after the old celebrity cooled down, top key: " << (recent.empty() ? -1 : recent.front().key)
+              << " (expect " << newCelebrity << ")\n";
+}
+
+// ---- ղ: KHashLruCaches<uint64_t, uint64_t>  SoA Ƭ vs ͨ LruNode Ƭ ----
+const size_t kLayoutCapacity = 1 << 18;
+const int kLayoutSliceNum = 4;
+
+// ֻڴļ, ¼ֽ( - ͷ, ͷŵľͰ鲻)
+static long long g_layoutNetBytes = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+    T* allocate(size_t n) {
+        g_layoutNetBytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        g_layoutNetBytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+// ͨ÷Ƭݽṹ KLruCache ͬ: unordered_map<Key, shared_ptr<LruNode>> + ͷβƽڵ
+double genericLayoutBytesPerEntry() {
+    using Node = KamaCache::LruNode<uint64_t, uint64_t>;
+    using NodeMap = std::unordered_map<uint64_t, std::shared_ptr<Node>, std::hash<uint64_t>, std::equal_to<uint64_t>,
+        CountingAllocator<std::pair<const uint64_t, std::shared_ptr<Node>>>>;
+    g_layoutNetBytes = 0;
+    std::vector<NodeMap> slices(kLayoutSliceNum);
+    std::vector<std::shared_ptr<Node>> dummies;
+    for (int i = 0; i < kLayoutSliceNum * 2; ++i)
+        dummies.push_back(std::allocate_shared<Node>(CountingAllocator<Node>(), 0, 0));
+    for (uint64_t key = 0; key < kLayoutCapacity; ++key)
+        slices[key % kLayoutSliceNum][key] = std::allocate_shared<Node>(CountingAllocator<Node>(), key, key);
+    return static_cast<double>(g_layoutNetBytes) / kLayoutCapacity;
+}
+
+// SoA ƬԤȫ, ֱȡ memoryBytes
+double compactLayoutBytesPerEntry() {
+    size_t sliceSize = static_cast<size_t>(std::ceil(kLayoutCapacity / static_cast<double>(kLayoutSliceNum)));
+    size_t bytes = 0;
+    for (int i = 0; i < kLayoutSliceNum; ++i)
+        bytes += KamaCache::KCompactLruCache<uint64_t, uint64_t>(sliceSize).memoryBytes();
+    return static_cast<double>(bytes) / kLayoutCapacity;
+}
+
+template <typename Cache>
+void benchLruLayout(const char* name, double bytesPerEntry) {
+    const size_t capacity = kLayoutCapacity;
+    const int ops = 2000000;
+
+    std::unique_ptr<Cache> cache(new Cache(capacity, kLayoutSliceNum));
+    for (uint64_t key = 0; key < capacity; ++key)
+        cache->put(key, key);
+
+    // key ռΪ 2 , Լһ get δв̭
+    std::mt19937_64 rng(1);
+    std::vector<uint64_t> keys(ops);
+    for (auto& key : keys)
+        key = rng() % (capacity * 2);
+    size_t hits = 0;
+    uint64_t value = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t key : keys) {
+        if (cache->get(key, value))
+            ++hits;
+        else
+            cache->put(key, key);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << "  bytes/entry: " << bytesPerEntry
+              << "  throughput: " << ops / seconds / 1e6 << " Mops/s"
+              << "  hitRatio: " << 100.0 * hits / ops << "%\n";
+}
+
+void testCompactLayout() {
+    std::cout << "\n==== compact layout (uint64_t -> uint64_t, 16B payload) ====\n";
+    benchLruLayout<KHashLruCaches<uint64_t, uint64_t>>("compact SoA   ", compactLayoutBytesPerEntry());
+    benchLruLayout<KHashLruCaches<uint64_t, uint64_t, KLruCache<uint64_t, uint64_t>>>("generic node  ", genericLayoutBytesPerEntry());
+}
+
+// ---- ʾ: ȫɨڼ乤 ----
+double runScanWhileServing(bool scanMode) {
+    const int capacity = 8000;
+    const int workingSet = 7000;
+    const int scanKeys = 1000000;
+    KHashLruCaches<int, int> cache(capacity, 4);
+    for (int key = 0; key < workingSet; ++key)
+        cache.put(key, key);
+
+    std::atomic<bool> scanning(true);
+    std::thread scanner([&] {
+        std::unique_ptr<KScanModeGuard> guard(scanMode ? new KScanModeGuard() : nullptr);
+        int value = 0;
+        for (int key = workingSet; key < workingSet + scanKeys; ++key) {
+            if (!cache.get(key, value))
+                cache.put(key, key);
+        }
+        scanning = false;
+    });
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> hotKey(0, workingSet - 1);
+    size_t hits = 0;
+    size_t total = 0;
+    int value = 0;
+    while (scanning) {
+        int key = hotKey(rng);
+        if (cache.get(key, value))
+            ++hits;
+        else
+            cache.put(key, key);
+        ++total;
+    }
+    scanner.join();
+    return total ? 100.0 * hits / total : 0;
+}
+
+void testScanResistance() {
+    std::cout << "\n==== access hints: working set hit ratio during a concurrent scan ====\n";
+    std::cout << "plain get/put scan      : " << runScanWhileServing(false) << "%\n";
+    std::cout << "KScanModeGuard scan     : " << runScanWhileServing(true) << "%\n";
+
+    // סĿɨвᱻ̭
+    KHashLruCaches<int, int> cache(100, 1);
+    cache.put(-1, 42);
+    cache.pin(-1);
+    for (int key = 0; key < 10000; ++key)
+        cache.put(key, key);
+    int value = 0;
+    std::cout << "pinned key after 10000 inserts: " << (cache.peek(-1, value) ? "exist" : "not exist") << "\n";
+
+    // LFU: סƵ key , Ψһ̭ key Ƶγ INT8_MAX, Ӧ̭Ƕ²
+    KLfuCache<int, int> lfu(2);
+    lfu.put(1, 1);
+    lfu.put(2, 2);
+    for (int i = 0; i < 200; ++i)
+        lfu.get(2, value);
+    lfu.pin(1);
+    lfu.put(3, 3);
+    std::cout << "LFU pinned low-freq key 1: " << (lfu.peek(1, value) ? "exist" : "not exist")
+              << "  high-freq key 2: " << (lfu.peek(2, value) ? "exist" : "not exist")
+              << "  new key 3: " << (lfu.peek(3, value) ? "exist" : "not exist") << "\n";
+}
+
+// ---- Э̽ӿ: Ƭ, ӿ co_await ӿڵĵβӳٷֲ ----
+void printLatency(const char* name, std::vector<double>& latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&](double q) { return latencies[static_cast<size_t>(q * (latencies.size() - 1))]; };
+    std::cout << name << "  p50: " << at(0.5) << "ns  p99: " << at(0.99)
+              << "ns  p99.9: " << at(0.999) << "ns  max: " << latencies.back() << "ns\n";
+}
+
+double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+KTask<void> asyncWorker(KAsyncHashCaches<int, int>& cache, KRunLoop& loop, int seed, int ops, int keySpace,
+                        std::vector<double>& latencies) {
+    std::mt19937 rng(seed);
+    for (int i = 0; i < ops; ++i) {
+        int key = static_cast<int>(rng() % keySpace);
+        auto start = std::chrono::steady_clock::now();
+        std::optional<int> value = co_await cache.getAsync(key);
+        if (!value)
+            co_await cache.putAsync(key, key);
+        latencies.push_back(elapsedNs(start));
+        co_await loop.schedule(); // óִ, ģ¼ѭϵЭ
+    }
+}
+
+KTask<int> slowLoad(KRunLoop& loop, int key, int& loads) {
+    co_await loop.schedule(); // ģһ첽 I/O
+    ++loads;
+    co_return key * 10;
+}
+
+KTask<void> loadTwice(KAsyncHashCaches<int, int>& cache, KRunLoop& loop, int& loads, int& result) {
+    auto loader = [&](int key) { return slowLoad(loop, key, loads); };
+    co_await cache.getOrLoadAsync(7, loader);
+    result = co_await cache.getOrLoadAsync(7, loader);
+}
+
+// ¼ get ʲôɨģʽִСco_await ֮ĸ̼߳; key 0  get ռסƬֱ
+std::atomic<bool> g_probeHolding(false);
+std::atomic<bool> g_probeRelease(false);
+std::thread::id g_probeThread;
+bool g_probeScanMode = false;
+
+struct ThreadProbeSlice {
+    explicit ThreadProbeSlice(size_t) {}
+    bool get(int key, int& value) {
+        if (key == 0) {
+            g_probeHolding = true;
+            while (!g_probeRelease)
+                std::this_thread::yield();
+            return false;
+        }
+        g_probeScanMode = KScanModeGuard::active();
+        value = key;
+        return true;
+    }
+    void put(int, int) {}
+};
+
+KTask<void> probeGet(KAsyncHashCaches<int, int, ThreadProbeSlice>& cache, int key) {
+    co_await cache.getAsync(key);
+    if (key != 0)
+        g_probeThread = std::this_thread::get_id();
+}
+
+// ȴƬЭɳ̴߳Ϊִٽ, Լʱɨģʽִ, ֮صԼִ̼߳
+void testAsyncAffinity() {
+    KAsyncHashCaches<int, int, ThreadProbeSlice> cache(1, 1);
+    std::thread holder([&] {
+        KScanModeGuard scan; // ̴߳ɨģʽ
+        KRunLoop loop;
+        loop.spawn(probeGet(cache, 0));
+        loop.run();
+    });
+    while (!g_probeHolding)
+        std::this_thread::yield();
+    std::thread::id waiterThread;
+    std::thread waiter([&] {
+        waiterThread = std::this_thread::get_id();
+        KRunLoop loop;
+        loop.spawn(probeGet(cache, 1));
+        loop.run();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); //  waiter Ӻٷг
+    g_probeRelease = true;
+    holder.join();
+    waiter.join();
+    std::cout << "waiter continued on its own executor thread: " << (g_probeThread == waiterThread ? "yes" : "no")
+              << "  saw the releaser's scan mode: " << (g_probeScanMode ? "yes" : "no") << "\n";
+}
+
+void testAsyncCache() {
+    std::cout << "\n==== coroutine API (1 slice, high contention) ====\n";
+    const int threadNum = 4;
+    const int coroutinesPerThread = 16;
+    const int opsPerCoroutine = 20000;
+    const int capacity = 1000;
+    const int keySpace = capacity * 2;
+
+    // ӿ: ÿ߳һ
+    {
+        KHashLruCaches<int, int> cache(capacity, 1);
+        std::vector<std::vector<double>> perThread(threadNum);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadNum; ++t) {
+            threads.emplace_back([&, t] {
+                std::mt19937 rng(t);
+                int value = 0;
+                perThread[t].reserve(coroutinesPerThread * opsPerCoroutine);
+                for (int i = 0; i < coroutinesPerThread * opsPerCoroutine; ++i) {
+                    int key = static_cast<int>(rng() % keySpace);
+                    auto start = std::chrono::steady_clock::now();
+                    if (!cache.get(key, value))
+                        cache.put(key, key);
+                    perThread[t].push_back(elapsedNs(start));
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        std::vector<double> all;
+        for (auto& latencies : perThread)
+            all.insert(all.end(), latencies.begin(), latencies.end());
+        printLatency("blocking get/put     ", all);
+    }
+
+    // Э̽ӿ: ÿ߳һ KRunLoop, ܶЭ
+    {
+        KAsyncHashCaches<int, int> cache(capacity, 1);
+        std::vector<std::vector<double>> perCoroutine(threadNum * coroutinesPerThread);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadNum; ++t) {
+            threads.emplace_back([&, t] {
+                KRunLoop loop;
+                for (int c = 0; c < coroutinesPerThread; ++c) {
+                    auto& latencies = perCoroutine[t * coroutinesPerThread + c];
+                    latencies.reserve(opsPerCoroutine);
+                    loop.spawn(asyncWorker(cache, loop, t * coroutinesPerThread + c, opsPerCoroutine, keySpace, latencies));
+                }
+                loop.run();
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        std::vector<double> all;
+        for (auto& latencies : perCoroutine)
+            all.insert(all.end(), latencies.begin(), latencies.end());
+        printLatency("co_await getAsync/put", all);
+    }
+
+    // getOrLoadAsync: ڶζȡ, ִֻһ
+    KAsyncHashCaches<int, int> cache(capacity, 4);
+    KRunLoop loop;
+    int loads = 0;
+    int result = 0;
+    loop.spawn(loadTwice(cache, loop, loads, result));
+    loop.run();
+    std::cout << "getOrLoadAsync result: " << result << "  loads: " << loads << "\n";
+    testAsyncAffinity();
+}
+
+int main() {
+    testLfuAging();
+    testCostAwareEviction();
+    testTenantQuota();
+    testHotKeys();
+    testCompactLayout();
+    testScanResistance();
+    testAsyncCache();
     return 0;
 }
\ No newline at end of file